@@ -0,0 +1,253 @@
+#include "AllocationTracker.h"
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    struct TagCounters {
+        std::atomic<std::uint64_t> allocations{ 0 };
+        std::atomic<std::uint64_t> bytes{ 0 };
+        std::atomic<std::int64_t> liveBytes{ 0 };
+        std::atomic<std::int64_t> peakLiveBytes{ 0 };
+    };
+
+    std::atomic<std::uint64_t> allocationCount{ 0 };
+    std::atomic<bool> trackingEnabled{ false };
+    TagCounters totals;
+    TagCounters tagCounters[AllocationTracker::tagCount];
+    thread_local AllocationTag currentTag = AllocationTag::Untagged;
+
+    AllocationTracker::TagStats snapshot(TagCounters& counters) {
+        AllocationTracker::TagStats stats;
+        stats.allocations = counters.allocations.exchange(0, std::memory_order_relaxed);
+        stats.bytes = counters.bytes.exchange(0, std::memory_order_relaxed);
+        stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+        stats.peakLiveBytes = std::max(counters.peakLiveBytes.exchange(stats.liveBytes, std::memory_order_relaxed),
+            stats.liveBytes);
+        return stats;
+    }
+
+#if ENGINE_ALLOC_TRACKING
+    void raisePeak(std::atomic<std::int64_t>& peak, std::int64_t value) {
+        std::int64_t current = peak.load(std::memory_order_relaxed);
+        while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void charge(TagCounters& counters, std::size_t size) {
+        counters.allocations.fetch_add(1, std::memory_order_relaxed);
+        counters.bytes.fetch_add(size, std::memory_order_relaxed);
+        const std::int64_t live = counters.liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed)
+            + static_cast<std::int64_t>(size);
+        raisePeak(counters.peakLiveBytes, live);
+    }
+
+    // Every block carries a header just below the payload so frees can be
+    // charged back to the tag that made them and find the malloc'd base.
+    struct alignas(16) BlockHeader {
+        std::size_t size;
+        std::uint32_t offset; // payload minus malloc'd base
+        std::uint8_t tag;
+        bool tracked;
+    };
+    static_assert(sizeof(BlockHeader) == 16, "BlockHeader must preserve malloc alignment");
+
+    constexpr std::uint8_t untrackedTag = 0xFF;
+
+    void* trackedAllocate(std::size_t size, std::size_t alignment = alignof(BlockHeader)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        // malloc is at least 16-byte aligned, so over-aligned payloads need
+        // alignment - 16 bytes of slack on top of the header.
+        alignment = std::max(alignment, alignof(BlockHeader));
+        const std::size_t overhead = sizeof(BlockHeader) + alignment - alignof(BlockHeader);
+        if (size > SIZE_MAX - overhead) {
+            throw std::bad_alloc();
+        }
+        void* block = nullptr;
+        while (!(block = std::malloc(overhead + size))) {
+            std::new_handler handler = std::get_new_handler();
+            if (!handler) {
+                throw std::bad_alloc();
+            }
+            handler();
+        }
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block);
+        const std::uintptr_t payload = (base + sizeof(BlockHeader) + alignment - 1) & ~(alignment - 1);
+        BlockHeader* header = reinterpret_cast<BlockHeader*>(payload) - 1;
+        header->size = size;
+        header->offset = static_cast<std::uint32_t>(payload - base);
+        header->tag = untrackedTag;
+        header->tracked = trackingEnabled.load(std::memory_order_relaxed);
+        if (header->tracked) {
+            header->tag = static_cast<std::uint8_t>(currentTag);
+            charge(totals, size);
+            charge(tagCounters[header->tag], size);
+        }
+        return header + 1;
+    }
+
+    void trackedFree(void* memory) {
+        if (!memory) {
+            return;
+        }
+        BlockHeader* header = static_cast<BlockHeader*>(memory) - 1;
+        if (header->tracked) {
+            const std::int64_t size = static_cast<std::int64_t>(header->size);
+            totals.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+            tagCounters[header->tag].liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        }
+        std::free(static_cast<char*>(memory) - header->offset);
+    }
+
+    void* trackedAllocateNoThrow(std::size_t size, std::size_t alignment = alignof(BlockHeader)) noexcept {
+        try {
+            return trackedAllocate(size, alignment);
+        }
+        catch (...) {
+            return nullptr;
+        }
+    }
+#endif
+}
+
+std::uint64_t AllocationTracker::getAllocationCount() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::setEnabled(bool enabled) {
+    trackingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool AllocationTracker::isEnabled() {
+    return compiledIn && trackingEnabled.load(std::memory_order_relaxed);
+}
+
+void AllocationTracker::beginFrame() {
+    snapshot(totals);
+    for (TagCounters& counters : tagCounters) {
+        snapshot(counters);
+    }
+}
+
+AllocationTracker::FrameStats AllocationTracker::endFrame() {
+    FrameStats frame;
+    const TagStats total = snapshot(totals);
+    frame.allocations = total.allocations;
+    frame.bytes = total.bytes;
+    frame.liveBytes = total.liveBytes;
+    frame.peakLiveBytes = total.peakLiveBytes;
+    for (std::size_t i = 0; i < tagCount; ++i) {
+        frame.tags[i] = snapshot(tagCounters[i]);
+    }
+    return frame;
+}
+
+const char* AllocationTracker::getTagName(AllocationTag tag) {
+    switch (tag) {
+    case AllocationTag::Untagged:
+        return "untagged";
+    case AllocationTag::SceneUpdate:
+        return "scene_update";
+    case AllocationTag::TilemapRender:
+        return "tilemap_render";
+    case AllocationTag::EngineRender:
+        return "engine_render";
+    case AllocationTag::SpawnProjectile:
+        return "spawn_projectile";
+    default:
+        return "unknown";
+    }
+}
+
+AllocationScope::AllocationScope(AllocationTag tag)
+    : previous(currentTag) {
+    currentTag = tag;
+}
+
+AllocationScope::~AllocationScope() {
+    currentTag = previous;
+}
+
+#if ENGINE_ALLOC_TRACKING
+void* operator new(std::size_t size) {
+    return trackedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return trackedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocateNoThrow(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return trackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return trackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocateNoThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedFree(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedFree(memory);
+}
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+// Global operator new/delete hooks (AllocationTracker.cpp). Every allocation
+// is counted; when tracking is enabled each one is also charged, with its
+// size, to the subsystem tag active on the allocating thread, and live and
+// peak memory are tracked per tag and per frame.
+//
+// The hooks are only compiled in with ENGINE_ALLOC_TRACKING=1. They put a
+// header in front of every block, so they also require SFML to be linked
+// statically: a block allocated inside an SFML DLL and freed here (or the
+// other way round) would corrupt the heap. Otherwise the counts read 0.
+#ifndef ENGINE_ALLOC_TRACKING
+#define ENGINE_ALLOC_TRACKING 0
+#endif
+enum class AllocationTag : std::uint8_t {
+    Untagged,
+    SceneUpdate,
+    TilemapRender,
+    EngineRender,
+    SpawnProjectile,
+    Count
+};
+
+namespace AllocationTracker {
+    constexpr std::size_t tagCount = static_cast<std::size_t>(AllocationTag::Count);
+    constexpr bool compiledIn = ENGINE_ALLOC_TRACKING != 0;
+
+    struct TagStats {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        std::int64_t liveBytes = 0;
+        std::int64_t peakLiveBytes = 0;
+    };
+
+    struct FrameStats {
+        std::uint64_t allocations = 0;
+        std::uint64_t bytes = 0;
+        std::int64_t liveBytes = 0;
+        std::int64_t peakLiveBytes = 0;
+        std::array<TagStats, tagCount> tags{};
+    };
+
+    std::uint64_t getAllocationCount();
+
+    // Off by default; only allocations made while enabled are charged.
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // Starts a new frame window; endFrame() returns what it saw.
+    void beginFrame();
+    FrameStats endFrame();
+
+    const char* getTagName(AllocationTag tag);
+}
+
+// Charges allocations on this thread to tag until the scope ends.
+class AllocationScope {
+public:
+    explicit AllocationScope(AllocationTag tag);
+    ~AllocationScope();
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+private:
+    AllocationTag previous;
+};
@@ -78,9 +78,7 @@ public:
 
         int row = (state == AnimState::Idle) ? idleRow : walkRow;
 
-        spriteComp->getSprite().setTextureRect(
-            sf::IntRect(currentFrame * this->frameWidth, row, this->frameWidth, this->frameHeight)
-        );
+        spriteComp->getSprite().setTextureRect(frameRect(currentFrame, row));
     }
 
     void update(float dt) override {
@@ -99,11 +97,16 @@ public:
         if (currentFrame > end)
             currentFrame = start;
 
-        spriteComp->getSprite().setTextureRect(
-            sf::IntRect(currentFrame * frameWidth, row, frameWidth, frameHeight)
-        );
+        spriteComp->getSprite().setTextureRect(frameRect(currentFrame, row));
     }
     private: 
+        // Frames are laid out inside the sprite's texture region, which is the
+        // whole texture unless the sprite comes from an atlas page.
+        sf::IntRect frameRect(int frame, int rowOffset) const {
+            const sf::IntRect& region = spriteComp->getTextureRegion();
+            return sf::IntRect(region.left + frame * frameWidth, region.top + rowOffset, frameWidth, frameHeight);
+        }
+
         void configureFromTexture(bool resetState) {
             const sf::Texture* tex = spriteComp ? spriteComp->getSprite().getTexture() : nullptr;
             if (!tex) {
@@ -113,7 +116,8 @@ public:
             frameWidth = baseFrameWidth;
             frameHeight = baseFrameHeight;
 
-            const auto size = tex->getSize();
+            const sf::IntRect& region = spriteComp->getTextureRegion();
+            const sf::Vector2u size(static_cast<unsigned int>(region.width), static_cast<unsigned int>(region.height));
             if (frameCount > 0) {
                 frameWidth = static_cast<int>(size.x) / frameCount;
 
@@ -131,13 +135,20 @@ public:
 
             idleRow = 0;
 
-            const auto textSize = tex->getSize();
-            const int rows = (frameHeight > 0) ? static_cast<int>(textSize.y) / frameHeight : 0;
-            const int cols = (frameWidth > 0) ? static_cast<int>(textSize.x) / frameWidth : 0;
+            const int rows = (frameHeight > 0) ? static_cast<int>(size.y) / frameHeight : 0;
+            const int cols = (frameWidth > 0) ? static_cast<int>(size.x) / frameWidth : 0;
 
             walkRow = (rows > 1) ? frameHeight : idleRow;
             if (rows > 0 && cols > 0) {
-                const sf::Image image = tex->copyToImage();
+                // Atlas sprites carry a CPU copy of their page; only plain
+                // textures pay for a GPU readback.
+                sf::Image readback;
+                const sf::Image* regionImage = spriteComp->getRegionImage();
+                if (!regionImage) {
+                    readback = tex->copyToImage();
+                    regionImage = &readback;
+                }
+                const sf::Image& image = *regionImage;
                 float bestScore = -1.f;
                 int bestRow = walkRow;
 
@@ -149,8 +160,8 @@ public:
 
                     for (int y = 0; y < frameHeight; ++y) {
                         const int globalY = yStart + y;
-                        for (unsigned int x = 0; x < textSize.x; ++x) {
-                            const sf::Color px = image.getPixel(x, globalY);
+                        for (unsigned int x = 0; x < size.x; ++x) {
+                            const sf::Color px = image.getPixel(region.left + x, region.top + globalY);
 
                             alphaSum += px.a;
                             weightSum += static_cast<unsigned long long>(px.a) * y;
@@ -185,9 +196,7 @@ public:
             }
 
             const int row = (state == AnimState::Idle) ? idleRow : walkRow;
-            spriteComp->getSprite().setTextureRect(
-                sf::IntRect(currentFrame * frameWidth, row, frameWidth, frameHeight)
-            );
+            spriteComp->getSprite().setTextureRect(frameRect(currentFrame, row));
         }
 
 
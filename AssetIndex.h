@@ -0,0 +1,68 @@
+#pragma once
+#include <filesystem>
+#include <unordered_set>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cctype>
+
+// One recursive scan of the asset directory, so candidate path lists can be
+// filtered in memory instead of probing the disk with failing loads.
+class AssetIndex {
+public:
+    void scan(const std::string& directory) {
+        files.clear();
+        std::error_code error;
+        std::filesystem::recursive_directory_iterator it(directory, error);
+        if (error) {
+            return;
+        }
+        for (const auto& entry : it) {
+            if (entry.is_regular_file(error)) {
+                files.insert(normalize(entry.path().generic_string()));
+            }
+        }
+        scanned = true;
+    }
+
+    bool isScanned() const {
+        return scanned;
+    }
+
+    // Unscanned indexes report everything as present so callers fall back to
+    // plain load attempts.
+    bool contains(const std::string& path) const {
+        return !scanned || files.count(normalize(path)) > 0;
+    }
+
+    std::vector<std::string> filterExisting(const std::vector<std::string>& candidates) const {
+        std::vector<std::string> existing;
+        existing.reserve(candidates.size());
+        for (const auto& path : candidates) {
+            if (contains(path)) {
+                existing.push_back(path);
+            }
+        }
+        return existing;
+    }
+
+    std::size_t size() const {
+        return files.size();
+    }
+
+private:
+    std::unordered_set<std::string> files;
+    bool scanned = false;
+
+    // Case-folded so the index agrees with case-insensitive filesystems; a
+    // false positive only costs the load attempt it would have cost anyway.
+    static std::string normalize(std::string path) {
+        std::replace(path.begin(), path.end(), '\\', '/');
+        if (path.rfind("./", 0) == 0) {
+            path.erase(0, 2);
+        }
+        std::transform(path.begin(), path.end(), path.begin(),
+            [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return path;
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <exception>
+#include "AssetIndex.h"
+#include "Logger.h"
+
+// Decodes files on a worker thread and hands results back to the main thread,
+// where anything touching the GL context (texture uploads, entity creation)
+// runs inside a per-frame time budget.
+class AssetLoader {
+public:
+    using Completion = std::function<void()>;
+    using Job = std::function<Completion()>;
+
+    AssetLoader()
+        : worker([this] { workerLoop(); }) {
+    }
+
+    ~AssetLoader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wakeWorker.notify_all();
+        worker.join();
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // job runs on the worker and returns the completion to run on the main thread.
+    void enqueue(Job job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.push_back(std::move(job));
+            ++pending;
+        }
+        wakeWorker.notify_one();
+    }
+
+    // Candidates missing from the index are dropped before the job is queued.
+    void setAssetIndex(const AssetIndex* index) {
+        assetIndex = index;
+    }
+
+    // Decodes the first candidate that loads; onReady receives nullptr if none did.
+    void requestImage(std::vector<std::string> candidates,
+        std::function<void(const sf::Image*, const std::string&)> onReady) {
+        if (assetIndex) {
+            candidates = assetIndex->filterExisting(candidates);
+        }
+        enqueue([candidates = std::move(candidates), onReady = std::move(onReady)]() -> Completion {
+            auto image = std::make_shared<sf::Image>();
+            for (const auto& path : candidates) {
+                if (image->loadFromFile(path)) {
+                    return [image, path, onReady] { onReady(image.get(), path); };
+                }
+            }
+            return [onReady] { onReady(nullptr, std::string()); };
+        });
+    }
+
+    // Runs work on the worker; onReady receives nullptr if work threw.
+    template <typename T>
+    void requestResult(std::function<T()> work, std::function<void(T*)> onReady) {
+        enqueue([work = std::move(work), onReady = std::move(onReady)]() -> Completion {
+            try {
+                auto result = std::make_shared<T>(work());
+                return [result, onReady] { onReady(result.get()); };
+            }
+            catch (const std::exception& ex) {
+                Log::error(LogCategory::Assets, "Background load failed: %s", ex.what());
+                return [onReady] { onReady(nullptr); };
+            }
+        });
+    }
+
+    // Runs finished completions until budget is spent. At least one runs per
+    // call so uploads always make progress on slow frames.
+    void pumpCompletions(sf::Time budget) {
+        sf::Clock clock;
+        do {
+            Completion completion;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (ready.empty()) {
+                    return;
+                }
+                completion = std::move(ready.front());
+                ready.pop_front();
+            }
+            if (completion) {
+                completion();
+            }
+            --pending;
+        } while (clock.getElapsedTime() < budget);
+    }
+
+    // Blocks until every queued job has been decoded and completed.
+    void finishAll() {
+        while (!isIdle()) {
+            pumpCompletions(sf::Time::Zero);
+            std::this_thread::yield();
+        }
+    }
+
+    bool isIdle() const {
+        return pending.load() == 0;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable wakeWorker;
+    std::deque<Job> jobs;
+    std::deque<Completion> ready;
+    std::atomic<int> pending{ 0 };
+    bool stopping = false;
+    const AssetIndex* assetIndex = nullptr;
+    std::thread worker;
+
+    void workerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wakeWorker.wait(lock, [this] { return stopping || !jobs.empty(); });
+                if (stopping) {
+                    return;
+                }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            Completion completion = job();
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(std::move(completion));
+        }
+    }
+};
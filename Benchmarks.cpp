@@ -0,0 +1,316 @@
+#include "Benchmarks.h"
+#include "Scene.h"
+#include "Entity.h"
+#include "Tilemap.h"
+#include "TransformComponent.h"
+#include "SpriteComponent.h"
+#include "PhysicsComponent.h"
+#include "MovementComponent.h"
+#include "AnimationComponent.h"
+#include "EnemyComponent.h"
+#include "TimerWheel.h"
+#include "LevelGenerator.h"
+#include "CommandLine.h"
+#include <SFML/Graphics.hpp>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+    using Benchmarks::Result;
+
+    // Keeps results observable so the optimiser can't drop the measured work.
+    volatile std::uint64_t sink = 0;
+
+    class Runner {
+    public:
+        explicit Runner(const Benchmarks::Options& options)
+            : options(options) {
+        }
+
+        // Runs body (which performs operationsPerIteration operations) in
+        // growing batches until minSecondsPerCase has elapsed.
+        void measure(const std::string& name, std::vector<std::pair<std::string, int>> params,
+            std::uint64_t operationsPerIteration, const std::function<void()>& body) {
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                return;
+            }
+            using Clock = std::chrono::steady_clock;
+            body(); // warm-up
+            Result result;
+            result.name = name;
+            result.params = std::move(params);
+            result.operationsPerIteration = std::max<std::uint64_t>(operationsPerIteration, 1);
+            std::uint64_t batch = 1;
+            while (result.totalSeconds < options.minSecondsPerCase) {
+                const auto start = Clock::now();
+                for (std::uint64_t i = 0; i < batch; ++i) {
+                    body();
+                }
+                result.totalSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+                result.iterations += batch;
+                batch *= 2;
+            }
+            std::cerr << "[bench] " << name;
+            for (const auto& param : result.params) {
+                std::cerr << ' ' << param.first << '=' << param.second;
+            }
+            std::cerr << ": " << result.nanosecondsPerOperation() << " ns/op\n";
+            results.push_back(std::move(result));
+        }
+
+        std::vector<Result> takeResults() {
+            return std::move(results);
+        }
+
+    private:
+        const Benchmarks::Options& options;
+        std::vector<Result> results;
+    };
+
+    void writeJson(std::ostream& out, const std::vector<Result>& results) {
+        out << "{\n  \"suite\": \"engine-hot-paths\",\n  \"results\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            out << (i == 0 ? "\n" : ",\n") << "    {\"name\": \"" << result.name << "\", \"params\": {";
+            for (std::size_t p = 0; p < result.params.size(); ++p) {
+                out << (p == 0 ? "" : ", ") << '"' << result.params[p].first << "\": " << result.params[p].second;
+            }
+            out << "}, \"iterations\": " << result.iterations
+                << ", \"operations_per_iteration\": " << result.operationsPerIteration
+                << ", \"total_seconds\": " << result.totalSeconds
+                << ", \"ns_per_op\": " << result.nanosecondsPerOperation() << '}';
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    // Seeded level with a coin for every four columns; no enemies, so the
+    // tilemap cases measure the map alone.
+    std::string writeLevel(int width, int height) {
+        LevelGenerator::Params params;
+        params.width = width;
+        params.height = height;
+        params.coins = width / 4;
+        params.powerups = 0;
+        params.enemies = 0;
+        const std::filesystem::path path = std::filesystem::temp_directory_path()
+            / ("bench_level_" + std::to_string(width) + "x" + std::to_string(height) + ".txt");
+        if (!LevelGenerator::writeFile(params, path.string())) {
+            throw std::runtime_error("could not write " + path.string());
+        }
+        return path.string();
+    }
+
+    Tilemap& loadLevel(Tilemap& tilemap, int width, int height) {
+        tilemap.loadFromFile(writeLevel(width, height));
+        return tilemap;
+    }
+
+    // Small texture shared by every benchmark sprite; six 32x32 frames.
+    const sf::Texture& benchTexture() {
+        static sf::Texture texture;
+        static bool created = false;
+        if (!created) {
+            created = true;
+            sf::Image image;
+            image.create(192, 32, sf::Color::White);
+            if (!texture.loadFromImage(image)) {
+                std::cerr << "[bench] could not create a texture; sprite cases run without one\n";
+            }
+        }
+        return texture;
+    }
+
+    SpriteComponent* addSprite(Entity* entity, TransformComponent* transform) {
+        TextureAtlas::Region region;
+        region.texture = &benchTexture();
+        region.rect = sf::IntRect(0, 0, 192, 32);
+        region.sourceSize = sf::Vector2i(192, 32);
+        return entity->addComponent<SpriteComponent>(region, transform);
+    }
+
+    Entity* addEnemy(Scene& scene, Tilemap& tilemap, TimerWheel& timers, float x, float y) {
+        Entity* enemy = scene.createEntity();
+        TransformComponent* transform = enemy->addComponent<TransformComponent>(x, y);
+        SpriteComponent* sprite = addSprite(enemy, transform);
+        enemy->addComponent<PhysicsComponent>(transform, &tilemap, 32.f, 32.f, false);
+        enemy->addComponent<EnemyComponent>(transform, &tilemap, &timers, 32.f, 32.f);
+        enemy->addComponent<AnimationComponent>(sprite, 32, 32, 6, 0.2f);
+        return enemy;
+    }
+
+    sf::Vector2f groundSpot(const Tilemap& tilemap, int index) {
+        const int columns = std::max(1, tilemap.getWidth() - 2);
+        const int column = 1 + index % columns;
+        return sf::Vector2f(static_cast<float>(column * tilemap.tileSize),
+            static_cast<float>((tilemap.getHeight() - 2) * tilemap.tileSize));
+    }
+
+    void benchTilemap(Runner& runner, const Benchmarks::Options& options) {
+        for (int width : options.levelWidths) {
+            const int height = options.levelHeight;
+            const std::vector<std::pair<std::string, int>> params{ { "width", width }, { "height", height } };
+
+            const std::string path = writeLevel(width, height);
+            runner.measure("Tilemap::loadFromFile", params, 1, [&] {
+                Tilemap tilemap;
+                tilemap.loadFromFile(path);
+                sink = sink + static_cast<std::uint64_t>(tilemap.getWidth());
+            });
+
+            Tilemap tilemap;
+            loadLevel(tilemap, width, height);
+            const int mapWidth = tilemap.getWidth();
+            const int mapHeight = tilemap.getHeight();
+            runner.measure("Tilemap::isSolid", params,
+                static_cast<std::uint64_t>(mapWidth) * static_cast<std::uint64_t>(mapHeight), [&] {
+                std::uint64_t solid = 0;
+                for (int y = 0; y < mapHeight; ++y) {
+                    for (int x = 0; x < mapWidth; ++x) {
+                        solid += tilemap.isSolid(x, y) ? 1u : 0u;
+                    }
+                }
+                sink = sink + solid;
+            });
+
+            // A player-sized box walking along the floor, one query per column.
+            const float tile = static_cast<float>(tilemap.tileSize);
+            const float rowY = static_cast<float>(mapHeight - 3) * tile;
+            runner.measure("Tilemap::collectIfOverlapping", params, static_cast<std::uint64_t>(mapWidth), [&] {
+                tilemap.resetCollectibles();
+                int collected = 0;
+                for (int x = 0; x < mapWidth; ++x) {
+                    collected += tilemap.collectIfOverlapping(sf::FloatRect(x * tile, rowY, tile, 2.f * tile));
+                }
+                sink = sink + static_cast<std::uint64_t>(collected);
+            });
+        }
+    }
+
+    void benchComponents(Runner& runner, const Benchmarks::Options& options) {
+        const float dt = 1.f / 60.f;
+        const int width = options.levelWidths.empty() ? 100 : options.levelWidths.back();
+        Tilemap tilemap;
+        loadLevel(tilemap, width, options.levelHeight);
+
+        {
+            Entity entity;
+            TransformComponent* transform = entity.addComponent<TransformComponent>(64.f, 64.f);
+            SpriteComponent* sprite = addSprite(&entity, transform);
+            entity.addComponent<PhysicsComponent>(transform, &tilemap);
+            entity.addComponent<MovementComponent>(transform, &tilemap);
+            AnimationComponent* animation = entity.addComponent<AnimationComponent>(sprite, 32, 32, 6, 0.2f);
+
+            // Looked up last-to-first so the worst case walks every component.
+            runner.measure("Entity::getComponent", { { "components", 5 } }, 1, [&] {
+                sink = sink + reinterpret_cast<std::uintptr_t>(entity.getComponent<AnimationComponent>());
+            });
+            runner.measure("AnimationComponent::configureFromTexture", {}, 1, [&] {
+                animation->refreshFromTexture();
+                sink = sink + static_cast<std::uint64_t>(animation->frameWidth);
+            });
+            runner.measure("MovementComponent::update", {}, 1, [&] {
+                entity.getComponent<MovementComponent>()->update(dt);
+                sink = sink + static_cast<std::uint64_t>(transform->position.x);
+            });
+        }
+
+        for (int count : options.entityCounts) {
+            const std::vector<std::pair<std::string, int>> params{ { "entities", count }, { "width", width } };
+
+            std::vector<std::unique_ptr<Entity>> bodies;
+            std::vector<PhysicsComponent*> physics;
+            bodies.reserve(static_cast<std::size_t>(count));
+            for (int i = 0; i < count; ++i) {
+                bodies.push_back(std::make_unique<Entity>());
+                const sf::Vector2f spot = groundSpot(tilemap, i);
+                TransformComponent* transform = bodies.back()->addComponent<TransformComponent>(spot.x, spot.y - 64.f);
+                physics.push_back(bodies.back()->addComponent<PhysicsComponent>(transform, &tilemap, 32.f, 32.f, false));
+            }
+            runner.measure("PhysicsComponent::update", params, static_cast<std::uint64_t>(count), [&] {
+                for (PhysicsComponent* body : physics) {
+                    body->update(dt);
+                }
+            });
+
+            Scene scene;
+            TimerWheel timers;
+            for (int i = 0; i < count; ++i) {
+                const sf::Vector2f spot = groundSpot(tilemap, i);
+                addEnemy(scene, tilemap, timers, spot.x, spot.y - 32.f);
+            }
+            runner.measure("Scene::update", params, 1, [&] {
+                timers.advance(dt);
+                scene.update(dt);
+            });
+        }
+    }
+}
+
+bool Benchmarks::parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        const char* flag = argv[i];
+        if (std::strcmp(flag, "--bench-out") == 0 && hasValue) {
+            options.outputPath = argv[++i];
+        }
+        else if (std::strcmp(flag, "--bench-widths") == 0 && hasValue) {
+            if (!CommandLine::parseList(argv[++i], options.levelWidths)) {
+                return CommandLine::reject("[bench]", flag, "a comma-separated list of integers", argv[i]);
+            }
+        }
+        else if (std::strcmp(flag, "--bench-height") == 0 && hasValue) {
+            if (!CommandLine::parseNumber(argv[++i], options.levelHeight)) {
+                return CommandLine::reject("[bench]", flag, "an integer", argv[i]);
+            }
+        }
+        else if (std::strcmp(flag, "--bench-entities") == 0 && hasValue) {
+            if (!CommandLine::parseList(argv[++i], options.entityCounts)) {
+                return CommandLine::reject("[bench]", flag, "a comma-separated list of integers", argv[i]);
+            }
+        }
+        else if (std::strcmp(flag, "--bench-seconds") == 0 && hasValue) {
+            if (!CommandLine::parseNumber(argv[++i], options.minSecondsPerCase)) {
+                return CommandLine::reject("[bench]", flag, "a number of seconds", argv[i]);
+            }
+        }
+        else if (std::strcmp(flag, "--bench-filter") == 0 && hasValue) {
+            options.filter = argv[++i];
+        }
+    }
+    return true;
+}
+
+std::vector<Benchmarks::Result> Benchmarks::collect(const Options& options) {
+    Runner runner(options);
+    benchTilemap(runner, options);
+    benchComponents(runner, options);
+    return runner.takeResults();
+}
+
+int Benchmarks::run(const Options& options) {
+    std::vector<Result> results;
+    try {
+        results = collect(options);
+    }
+    catch (const std::exception& error) {
+        std::cerr << "[bench] failed: " << error.what() << "\n";
+        return 1;
+    }
+    if (options.outputPath.empty()) {
+        writeJson(std::cout, results);
+        return 0;
+    }
+    std::ofstream out(options.outputPath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "[bench] could not write " << options.outputPath << "\n";
+        return 1;
+    }
+    writeJson(out, results);
+    return 0;
+}
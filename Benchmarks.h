@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+// Micro-benchmarks for engine hot paths, run with `--bench` instead of the
+// game. Results are written as JSON so runs can be tracked over time.
+namespace Benchmarks {
+    struct Options {
+        std::vector<int> levelWidths{ 100, 1000, 10000 };
+        int levelHeight = 20;
+        std::vector<int> entityCounts{ 10, 100, 1000 };
+        double minSecondsPerCase = 0.2;
+        std::string outputPath; // empty writes to stdout
+        std::string filter;     // only run cases whose name contains this
+    };
+
+    struct Result {
+        std::string name;
+        std::vector<std::pair<std::string, int>> params;
+        std::uint64_t iterations = 0;
+        double totalSeconds = 0.0;
+        std::uint64_t operationsPerIteration = 1;
+
+        double nanosecondsPerOperation() const {
+            const double operations = static_cast<double>(iterations * operationsPerIteration);
+            return operations > 0.0 ? totalSeconds * 1e9 / operations : 0.0;
+        }
+    };
+
+    // Reads --bench-* flags into options; anything else is left for the
+    // caller. False, after printing why, when a value is malformed.
+    bool parseOptions(int argc, char** argv, Options& options);
+
+    // Runs every case that passes the filter. Throws if a case can't be set up.
+    std::vector<Result> collect(const Options& options);
+
+    // Runs the suite and writes the JSON report. Returns a process exit code.
+    int run(const Options& options);
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Strict number parsing for the tool flags: the whole argument has to be a
+// number of the expected type, so "12abc" or "" is rejected rather than read
+// as 12 or thrown out of std::stoi.
+namespace CommandLine {
+    // Exit code for a malformed command line.
+    constexpr int usageError = 2;
+
+    template <typename Number>
+    bool parseNumber(const std::string& text, Number& value) {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        Number parsed{};
+        const std::from_chars_result result = std::from_chars(first, last, parsed);
+        if (first == last || result.ec != std::errc() || result.ptr != last) {
+            return false;
+        }
+        value = parsed;
+        return true;
+    }
+
+    // Comma-separated list such as "100,1000"; empty items are skipped.
+    template <typename Number>
+    bool parseList(const std::string& text, std::vector<Number>& values) {
+        std::vector<Number> parsed;
+        std::size_t start = 0;
+        while (start <= text.size()) {
+            const std::size_t comma = std::min(text.find(',', start), text.size());
+            const std::string item = text.substr(start, comma - start);
+            Number value{};
+            if (!item.empty()) {
+                if (!parseNumber(item, value)) {
+                    return false;
+                }
+                parsed.push_back(value);
+            }
+            start = comma + 1;
+        }
+        values = std::move(parsed);
+        return true;
+    }
+
+    // Prints "<tag> <flag> expects <expected>, got '<text>'" and returns false,
+    // so parsers can write `return CommandLine::reject(...)`.
+    inline bool reject(const char* tag, const char* flag, const char* expected, const char* text) {
+        std::cerr << tag << ' ' << flag << " expects " << expected << ", got '" << text << "'\n";
+        return false;
+    }
+}
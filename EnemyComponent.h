@@ -3,8 +3,12 @@
 #include "TransformComponent.h"
 #include "Entity.h"
 #include "Tilemap.h"
+#include "TileCollision.h"
 #include "SpriteComponent.h"
 #include "PhysicsComponent.h"
+#include "AnimationComponent.h"
+#include "TimerWheel.h"
+#include "Metrics.h"
 #include <algorithm>
 
 enum class EnemyType {
@@ -17,82 +21,74 @@ public:
     float speed = 60.f;
     int direction = -1;
     bool alive = true;
-    float deathTimer = 0.f;
     float deathDelay = 0.3f;
     float colliderWidth = 32.f;
     float colliderHeight = 32.f;
     float turnCooldown = 0.12f;
-    float turnTimer = 0.f;
+    // Pending timers on the shared wheel; cancelled if the enemy goes away first.
+    TimerWheel::Handle deathTimer;
+    TimerWheel::Handle turnTimer;
 
 
-    EnemyComponent(TransformComponent* transform, Tilemap* tilemap,
+    EnemyComponent(TransformComponent* transform, Tilemap* tilemap, TimerWheel* timers,
         float colliderWidth = 32.f, float colliderHeight = 32.f)
-        : transform(transform), tilemap(tilemap),
+        : transform(transform), tilemap(tilemap), timers(timers),
         colliderWidth(colliderWidth), colliderHeight(colliderHeight) {
+        Metrics::add(MetricGauge::Enemies, 1);
+    }
+
+    ~EnemyComponent() override {
+        Metrics::add(MetricGauge::Enemies, -1);
+        if (timers) {
+            timers->cancel(deathTimer);
+            timers->cancel(turnTimer);
+        }
+    }
+
+    // Squashes the enemy and removes it once deathDelay has passed.
+    void kill() {
+        if (!alive) {
+            return;
+        }
+        alive = false;
+        if (PhysicsComponent* physics = entity->getComponent<PhysicsComponent>()) {
+            physics->velocityY = 0.f;
+            physics->onGround = true;
+        }
+        if (SpriteComponent* sprite = entity->getComponent<SpriteComponent>()) {
+            const float currentXScale = sprite->getSprite().getScale().x;
+            sprite->getSprite().setScale(currentXScale, 0.25f);
+        }
+        if (AnimationComponent* anim = entity->getComponent<AnimationComponent>()) {
+            anim->paused = true;
+        }
+        if (!timers) {
+            entity->destroy();
+            return;
+        }
+        timers->cancel(turnTimer);
+        deathTimer = timers->schedule(deathDelay, [this] { entity->destroy(); });
     }
 
     void update(float dt) override {
         if (!transform || !tilemap) return;
         if (!alive) {
-            if (deathTimer > 0.f) {
-                deathTimer -= dt;
+            if (timers && timers->pending(deathTimer)) {
                 if (SpriteComponent* sprite = entity->getComponent<SpriteComponent>()) {
-                    const float t = std::clamp(deathTimer / std::max(deathDelay, 0.001f), 0.f, 1.f);
+                    const float t = std::clamp(timers->remaining(deathTimer) / std::max(deathDelay, 0.001f), 0.f, 1.f);
                     const float currentXScale = sprite->getSprite().getScale().x;
                     const float squash = 0.1f + 0.4f * t;
                     sprite->getSprite().setScale(currentXScale, squash);
                 }
-                if (deathTimer <= 0.f) {
-                    entity->destroy();
-
-                }
             }
             return;
         }
-        if (turnTimer > 0.f) {
-            turnTimer = std::max(0.f, turnTimer - dt);
-
-        }
-
-        float dx = direction * speed * dt;
-        float newX = transform->position.x + dx;
-
-        const float topY = transform->position.y + 1.f;
-        const float bottomY = transform->position.y + colliderHeight - 1.f;
-        const int tileYTop = static_cast<int>(topY) / tilemap->tileSize;
-        const int tileYBottom = static_cast<int>(bottomY) / tilemap->tileSize;
-        int tileXLeft = static_cast<int>(newX) / tilemap->tileSize;
-        int tileXRight = static_cast<int>(newX + colliderWidth - 1.f) / tilemap->tileSize;
-
-        bool hitWall = false;
-        auto isBlocked = [&](int tileX) {
-            for (int tileY = tileYTop; tileY <= tileYBottom; ++tileY) {
-                if (tilemap->isSolid(tileX, tileY)) {
-                    return true;
-                }
-            }
-            return false;
-            };
+        const bool canTurn = !timers || !timers->pending(turnTimer);
 
-
-        if (dx < 0.f) {
-            if (isBlocked(tileXLeft)) {
-                transform->position.x = (tileXLeft + 1) * tilemap->tileSize;
-                hitWall = true;
-            }
-            else {
-                transform->position.x = newX;
-            }
-        }
-        else if (dx > 0.f) {
-            if (isBlocked(tileXLeft)) {
-                transform->position.x = tileXRight * tilemap->tileSize - colliderWidth;
-                hitWall = true;
-            }
-            else {
-                transform->position.x = newX;
-            }
-        }
+        const TileCollision::Result contact = TileCollision::sweep(*tilemap, transform->position,
+            { colliderWidth, colliderHeight }, { direction * speed * dt, 0.f });
+        transform->position = contact.position;
+        const bool hitWall = contact.hitX();
 
         bool onGround = true;
         if (PhysicsComponent* physics = entity->getComponent<PhysicsComponent>()) {
@@ -100,22 +96,24 @@ public:
         }
 
         bool turned = false;
-        if (hitWall && onGround && turnTimer == 0.f) {
+        if (hitWall && onGround && canTurn) {
             direction *= -1;
             turned = true;
-            turnTimer = turnCooldown;
+            startTurnCooldown();
         }
 
-        if (onGround && !turned && turnTimer == 0.f) {
+        if (onGround && !turned && canTurn) {
             const float aheadX = direction < 0.f
-                ? transform->position.x - 1.f : transform->position.x + colliderHeight + 1.f;
-            const int tileAheadX = static_cast<int>(aheadX) / tilemap->tileSize;
-            const int tileBelow = static_cast<int>((bottomY + 1.f) / tilemap->tileSize);
+                ? transform->position.x - 1.f : transform->position.x + colliderWidth + 1.f;
+            const sf::Vector2f probe(aheadX, transform->position.y + colliderHeight - 1.f);
+            const float probeDepth = static_cast<float>(tilemap->tileSize) / 2.f;
 
 
-            if (!tilemap->isSolid(tileAheadX, tileBelow)) {
+            const std::uint8_t walkable = Tilemap::TileFlag::Solid | Tilemap::TileFlag::OneWay;
+            if (!tilemap->raycast(probe, { 0.f, 1.f }, probeDepth, walkable).hit
+                && !tilemap->platforms.hasPlatformBelow(probe, probeDepth)) {
                 direction *= -1;
-                turnTimer = turnCooldown;
+                startTurnCooldown();
             }
         }
 
@@ -127,4 +125,11 @@ public:
 private:
     TransformComponent* transform;
     Tilemap* tilemap;
+    TimerWheel* timers;
+
+    void startTurnCooldown() {
+        if (timers) {
+            turnTimer = timers->schedule(turnCooldown);
+        }
+    }
 };
\ No newline at end of file
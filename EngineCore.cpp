@@ -10,22 +10,34 @@
 #include "ProjectileComponent.h"
 #include "Tilemap.h"
 #include "AnimationComponent.h"
+#include "AllocationTracker.h"
+#include "Input.h"
+#include "Logger.h"
 #include <iostream>
 #include <exception>
 #include <filesystem>   // REQUIRED for current_path()
 #include <fstream>
 #include <algorithm>
 #include <cmath>
+#include <future>
+#include <charconv>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
 
 namespace {
+    void appendNumber(FrameString& text, int value) {
+        char digits[16];
+        const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        text.append(digits, end);
+    }
+
     std::filesystem::path findAssetsRoot() {
         std::filesystem::path current = std::filesystem::current_path();
         for (int depth = 0; depth < 5; ++depth) {
             std::filesystem::path candidate = current / "Assets";
-            if (std::filesystem::exists(candidate) && std::filesystem::is_directory(candidate)) {
+            std::error_code error;
+            if (std::filesystem::is_directory(candidate, error)) {
                 return candidate;
             }
             if (!current.has_parent_path()) {
@@ -36,6 +48,26 @@ namespace {
         return {};
     }
 
+    // Logs how long each startup phase took since the previous one.
+    class StartupPhaseLog {
+    public:
+        explicit StartupPhaseLog(const sf::Clock& startupClock)
+            : startupClock(startupClock),
+            lastMark(startupClock.getElapsedTime()) {
+        }
+
+        void mark(const char* phase) {
+            const sf::Time now = startupClock.getElapsedTime();
+            std::cout << "[startup] " << phase << ": "
+                << (now - lastMark).asMicroseconds() / 1000.0 << " ms\n";
+            lastMark = now;
+        }
+
+    private:
+        const sf::Clock& startupClock;
+        sf::Time lastMark;
+    };
+
     std::vector<std::string> getPlayerSpriteCandidates(EngineCore::PlayerPowerState powerState) {
         switch (powerState) {
         case EngineCore::PlayerPowerState::FireFlower:
@@ -71,10 +103,16 @@ namespace {
 }
 
 
-EngineCore::EngineCore()
-    : window("Alice Wild Adventure", 1920, 1080),
-    tilemap()
+EngineCore::EngineCore(bool headless)
+    : tilemap(),
+    headless(headless)
 {
+    if (!headless) {
+        window.create("Alice Wild Adventure", 1920, 1080);
+    }
+    std::cout << "[startup] window: " << startupClock.getElapsedTime().asMicroseconds() / 1000.0 << " ms\n";
+    StartupPhaseLog startup(startupClock);
+
     const std::filesystem::path assetsRoot = findAssetsRoot();
     if (!assetsRoot.empty()) {
         std::filesystem::current_path(assetsRoot.parent_path());
@@ -83,59 +121,32 @@ EngineCore::EngineCore()
         std::cerr << "Warning: Could not locate Assets directory from "
             << std::filesystem::current_path() << ".\n";
     }
+    assetIndex.scan("Assets");
+    assetLoader.setAssetIndex(&assetIndex);
+    startup.mark("asset scan");
+
+    // Start the slow, independent work first: texture decoding runs on the
+    // loader thread and the music stream opens on its own task while the
+    // main thread builds fonts and text.
+    requestStartupAssets();
+    std::future<bool> musicOpened;
+    if (!headless && assetIndex.contains("Assets/music.wav")) {
+        musicOpened = std::async(std::launch::async, [this] {
+            return backgroundMusic.openFromFile("Assets/music.wav");
+        });
+    }
+    startup.mark("queue background loads");
 
-    camera = window.getRenderWindow().getDefaultView();
+    camera = headless ? sf::View(sf::FloatRect(0.f, 0.f, 1920.f, 1080.f))
+        : window.getRenderWindow().getDefaultView();
 
     if (!uiFont.loadFromFile("Assets/DejaVuSans.ttf")) {
         std::cerr << "Failed to load UI font Assets/DejaVuSans.tff\n";
 
     }
-    livesText.setFont(uiFont);
-    livesText.setCharacterSize(20);
-    livesText.setFillColor(sf::Color::White);
-    livesText.setPosition(16.f, 12.f);
-
-    coinText.setFont(uiFont);
-    coinText.setCharacterSize(20);
-    coinText.setFillColor(sf::Color::White);
-    coinText.setPosition(150.f, 12.f);
-
-    scoreText.setFont(uiFont);
-    scoreText.setCharacterSize(18);
-    scoreText.setFillColor(sf::Color::White);
-    scoreText.setPosition(16.f, 40.f);
-
-    pauseText.setFont(uiFont);
-    pauseText.setCharacterSize(20);
-    pauseText.setFillColor(sf::Color::Yellow);
-    pauseText.setPosition(16.f, 40.f);
-
-    goalText.setFont(uiFont);
-    goalText.setCharacterSize(28);
-    goalText.setFillColor(sf::Color::Green);
-
-    gameOverText.setFont(uiFont);
-    gameOverText.setCharacterSize(32);
-    gameOverText.setFillColor(sf::Color::Red);
-
-    controlsText.setFont(uiFont);
-    controlsText.setCharacterSize(16);
-    controlsText.setFillColor(sf::Color(220, 220, 220));
-    controlsText.setPosition(16.f, 500.f);
-
-    powerText.setFont(uiFont);
-    powerText.setCharacterSize(20);
-    powerText.setFillColor(sf::Color::White);
-    powerText.setPosition(16.f, 66.f);
-
-    reserveText.setFont(uiFont);
-    reserveText.setCharacterSize(18);
-    reserveText.setFillColor(sf::Color::White);
-    reserveText.setPosition(16.f, 92.f);
-
-    levelText.setFont(uiFont);
-    levelText.setCharacterSize(20);
-    levelText.setFillColor(sf::Color::White);
+    startup.mark("font");
+    setupHud();
+    startup.mark("hud atlas");
 
     startMenuTitleText.setFont(uiFont);
     startMenuTitleText.setCharacterSize(40);
@@ -165,37 +176,174 @@ EngineCore::EngineCore()
     worldMapLevelText.setFont(uiFont);
     worldMapLevelText.setCharacterSize(22);
     worldMapLevelText.setFillColor(sf::Color::White);
+    startup.mark("menu text");
 
+    setupLevelList();
+    loadProgress();
+    currentLevelIndex = std::clamp(currentLevelIndex, 0, static_cast<int>(levels.size()) - 1);
+    selectedLevelIndex = std::clamp(selectedLevelIndex, 0, static_cast<int>(levels.size()) - 1);
+    // Starting from the menu always resets to the first level.
+    requestLevelData(0);
+    updateWorldMapText();
+    startup.mark("progress");
 
-
-    // ✅ TILEMAP MUST USE TILE TEXTURE (NOT PLAYER)
-    try {
-        tilemap.loadTileset("Assets/tileset.png", 16, 16);
-    }
-    catch (const std::exception& ex) {
-        std::cerr << "Failed to load tile image  Assets/tileset.png (" << ex.what() << "). Falling back to Assets/platform.png\n";
-        tilemap.loadTileset("Assets/platform.png", 32, 32);
-    }
-
-
-    if (backgroundMusic.openFromFile("Assets/music.wav")) {
+    if (musicOpened.valid() && musicOpened.get()) {
         backgroundMusic.setLoop(true);
         backgroundMusic.setVolume(40.f);
         backgroundMusic.play();
     }
-    else {
+    else if (!headless) {
         std::cerr << "Failed to load background music  Assets/music.wav\n";
     }
-    setupLevelList();
-    loadProgress();
-    currentLevelIndex = std::clamp(currentLevelIndex, 0, static_cast<int>(levels.size()) - 1);
-    selectedLevelIndex = std::clamp(selectedLevelIndex, 0, static_cast<int>(levels.size()) - 1);
-    loadLevel(currentLevelIndex);
-    updateWorldMapText();
-
-
-
+    startup.mark("music");
+    std::cout << "[startup] total before first frame: "
+        << startupClock.getElapsedTime().asMicroseconds() / 1000.0 << " ms\n";
+}
+void EngineCore::requestStartupAssets() {
+    // Everything drawn in a level is decoded and packed into shared atlas
+    // pages on the loader thread; only the page upload touches the main thread.
+    const std::vector<TextureAtlas::Source> sources = collectAtlasSources();
+    assetLoader.requestResult<TextureAtlas::Layout>(
+        [sources] { return TextureAtlas::pack(sources); },
+        [this](TextureAtlas::Layout* layout) {
+            if (!layout || !spriteAtlas.install(std::move(*layout))) {
+                Log::warning(LogCategory::Assets, "Atlas unavailable, loading textures individually");
+                requestUnpackedAssets();
+                return;
+            }
+            const bool platformTiles = spriteAtlas.find("Assets/tileset.png") == nullptr;
+            const int tileEdge = platformTiles ? 32 : 16;
+            const std::string tilesetPath = platformTiles ? "Assets/platform.png" : "Assets/tileset.png";
+            tilemap.useAtlas(spriteAtlas, tilesetPath, tileEdge, tileEdge);
+            requestTileProperties(tilesetPath);
+        });
+    tilemap.requestPowerupSheet(assetLoader);
+}
+std::vector<TextureAtlas::Source> EngineCore::collectAtlasSources() const {
+    std::vector<TextureAtlas::Source> sources;
+    auto addSource = [&sources](const std::string& path, bool trim) {
+        for (const auto& source : sources) {
+            if (source.key == path) {
+                return;
+            }
+        }
+        sources.push_back({ path, path, trim });
+    };
+    auto addFirstExisting = [&](const std::vector<std::string>& candidates, bool trim) {
+        const std::vector<std::string> existing = assetIndex.filterExisting(candidates);
+        if (!existing.empty()) {
+            addSource(existing.front(), trim);
+        }
+    };
 
+    // ✅ TILEMAP MUST USE TILE TEXTURE (NOT PLAYER)
+    addFirstExisting({ "Assets/tileset.png", "Assets/platform.png" }, false);
+    // Single-frame icons (also used as projectiles) are trimmed; sheets are
+    // never trimmed because their frame grid starts at the image corner.
+    for (int i = 0; i < 6; ++i) {
+        addFirstExisting(Tilemap::getPowerupTextureCandidates(static_cast<Tilemap::PowerupType>(i)), true);
+    }
+    addSource("Assets/player.png", false);
+    addSource("Assets/nathaniel.png", false);
+    for (int i = 0; i <= static_cast<int>(PlayerPowerState::FrogSuit); ++i) {
+        for (const auto& path : assetIndex.filterExisting(getPlayerSpriteCandidates(static_cast<PlayerPowerState>(i)))) {
+            addSource(path, false);
+        }
+    }
+    return sources;
+}
+void EngineCore::requestUnpackedAssets() {
+    assetLoader.requestImage({ "Assets/tileset.png", "Assets/platform.png" },
+        [this](const sf::Image* image, const std::string& path) {
+            if (!image) {
+                Log::error(LogCategory::Assets, "Failed to load tile image Assets/tileset.png or Assets/platform.png");
+                return;
+            }
+            const int tileEdge = (path == "Assets/platform.png") ? 32 : 16;
+            try {
+                tilemap.applyTilesetImage(*image, path, tileEdge, tileEdge);
+                requestTileProperties(path);
+            }
+            catch (const std::exception& ex) {
+                Log::error(LogCategory::Assets, "Failed to load tile image %s (%s)", path.c_str(), ex.what());
+            }
+        });
+    tilemap.requestPowerupTextures(assetLoader);
+}
+void EngineCore::requestTileProperties(const std::string& tilesetPath) {
+    const std::string path = Tilemap::tilePropertiesPathFor(tilesetPath);
+    if (!assetIndex.contains(path)) {
+        return;
+    }
+    assetLoader.requestResult<Tilemap::TileDefinitions>(
+        [path] { return Tilemap::parseTileDefinitions(path); },
+        [this](Tilemap::TileDefinitions* definitions) {
+            if (definitions) {
+                tilemap.applyTileDefinitions(std::move(*definitions));
+            }
+        });
+}
+SpriteComponent* EngineCore::addSpriteComponent(Entity* entity, const std::string& path, TransformComponent* transform) {
+    if (const TextureAtlas::Region* region = spriteAtlas.find(path)) {
+        return entity->addComponent<SpriteComponent>(*region, transform);
+    }
+    return entity->addComponent<SpriteComponent>(path, transform);
+}
+bool EngineCore::setSpriteSource(SpriteComponent* sprite, const std::string& path) {
+    if (const TextureAtlas::Region* region = spriteAtlas.find(path)) {
+        sprite->setRegion(*region);
+        return true;
+    }
+    return sprite->setTexture(path);
+}
+void EngineCore::requestLevelData(int levelIndex) {
+    if (levels.empty()) {
+        return;
+    }
+    const int safeIndex = std::clamp(levelIndex, 0, static_cast<int>(levels.size()) - 1);
+    if (safeIndex == requestedLevelIndex || (preparedLevel && preparedLevelIndex == safeIndex)) {
+        return;
+    }
+    requestedLevelIndex = safeIndex;
+    const std::string file = levels[safeIndex].file;
+    // Copied here: the loader must not read the live tilemap.
+    Tilemap::TileLayout layout = tilemap.getTileLayout();
+    assetLoader.requestResult<Tilemap::LevelData>(
+        [file, layout = std::move(layout)] {
+            Tilemap::LevelData level = Tilemap::parseLevelFile(file, layout.tileSize);
+            Tilemap::prepareGeometry(level, layout);
+            return level;
+        },
+        [this, safeIndex](Tilemap::LevelData* level) {
+            if (requestedLevelIndex == safeIndex) {
+                requestedLevelIndex = -1;
+            }
+            if (!level) {
+                return;
+            }
+            preparedLevel = std::move(*level);
+            preparedLevelIndex = safeIndex;
+        });
+}
+void EngineCore::setupHud() {
+    const float windowWidth = camera.getSize().x;
+    livesField = hud.addField({ 16.f, 12.f }, 20, sf::Color::White);
+    coinField = hud.addField({ 150.f, 12.f }, 20, sf::Color::White);
+    scoreField = hud.addField({ 16.f, 40.f }, 18, sf::Color::White);
+    pauseField = hud.addField({ 16.f, 40.f }, 20, sf::Color::Yellow);
+    powerField = hud.addField({ 16.f, 66.f }, 20, sf::Color::White);
+    reserveField = hud.addField({ 16.f, 92.f }, 18, sf::Color::White);
+    levelField = hud.addField({ windowWidth - 16.f, 12.f }, 20, sf::Color::White, Hud::Align::Right);
+    goalField = hud.addField({ windowWidth / 2.f, 100.f }, 28, sf::Color::Green, Hud::Align::Center);
+    gameOverField = hud.addField({ windowWidth / 2.f, 140.f }, 32, sf::Color::Red, Hud::Align::Left, 40);
+    controlsField = hud.addField({ 16.f, 500.f }, 16, sf::Color(220, 220, 220), Hud::Align::Left, 96);
+
+    // Static strings are laid out once; only visibility changes per frame.
+    hud.setText(pauseField, "Paused");
+    hud.setText(goalField, "Goal reached!");
+    hud.setText(gameOverField, "Gameover - Press R to Restart");
+    hud.setText(controlsField, "Move: A/D Jump/Fly: Space Run: Shift Throw: F Reserve: Q Reset: R Pause: P");
+    hud.bakeAtlas(uiFont);
 }
 void EngineCore::setupLevelList() {
     levels = {
@@ -228,6 +376,9 @@ void EngineCore::loadProgress() {
     }
 }
 void EngineCore::saveProgress() {
+    if (headless) {
+        return;
+    }
     std::ofstream out("save.dat", std::ios::trunc);
     if (!out.is_open()) {
         return;
@@ -268,47 +419,60 @@ void EngineCore::loadLevel(int levelIndex) {
     selectedLevelIndex = safeIndex;
     currentWorld = levels[safeIndex].world;
     currentLevel = levels[safeIndex].level;
-    tilemap.loadFromFile(levels[safeIndex].file);
+    if (preparedLevel && preparedLevelIndex == safeIndex) {
+        tilemap.applyLevel(std::move(*preparedLevel));
+        preparedLevel.reset();
+        preparedLevelIndex = -1;
+        Log::debug(LogCategory::Assets, "level %d applied from prefetch", safeIndex + 1);
+    }
+    else {
+        tilemap.loadFromFile(levels[safeIndex].file);
+        Log::debug(LogCategory::Assets, "level %d loaded synchronously", safeIndex + 1);
+    }
     if (tilemap.hasSpawnPoint()) {
         playerSpawn = tilemap.getSpawnPoint();
 
     }
     scene.clear();
+    timers.clear();
+    particles.clear();
     
     player = scene.createEntity();
 
     TransformComponent* transform = player->addComponent<TransformComponent>(playerSpawn.x, playerSpawn.y);
 
     SpriteComponent* sprite =
-        player->addComponent<SpriteComponent>("Assets/player.png", transform);
+        addSpriteComponent(player, "Assets/player.png", transform);
 
     player->addComponent<MovementComponent>(transform, &tilemap);
     player->addComponent<PhysicsComponent>(transform, &tilemap);
     player->addComponent<AnimationComponent>(sprite, 47, 0, 6, 0.12f);
 
-    for (const auto& enemySpawn : tilemap.getEnemySpawnPoints()) {
+    for (const auto& enemySpawn : tilemap.getEnemySpawnPoints(frameArena)) {
         Entity* goomba = scene.createEntity();
         TransformComponent* goombaTransform =
             goomba->addComponent<TransformComponent>(enemySpawn.x, enemySpawn.y);
         SpriteComponent* goombaSprite =
-            goomba->addComponent<SpriteComponent>("Assets/nathaniel.png", goombaTransform);
+            addSpriteComponent(goomba, "Assets/nathaniel.png", goombaTransform);
 
-        goombaSprite->getSprite().setTextureRect(sf::IntRect(0, 0, 32, 32));
+        const sf::IntRect goombaRegion = goombaSprite->getTextureRegion();
+        goombaSprite->getSprite().setTextureRect(sf::IntRect(goombaRegion.left, goombaRegion.top, 32, 32));
         goomba->addComponent<PhysicsComponent>(goombaTransform, &tilemap, 32.f, 32.f, false);
-        goomba->addComponent<EnemyComponent>(goombaTransform, &tilemap, 32.f, 32.f);
+        goomba->addComponent<EnemyComponent>(goombaTransform, &tilemap, &timers, 32.f, 32.f);
         goomba->addComponent<AnimationComponent>(goombaSprite, 47, 0, 6, 0.20f);
     }
     levelComplete = false;
-    goalMessageTimer = 0.f;
+    timers.cancel(goalMessageTimer);
     collectedCoins = 0;
     playerDying = false;
     invincible = false;
-    invincibilityTimer = 0.f;
+    timers.cancel(invincibilityTimer);
     powerupFlashTimer = 0.f;
-    attackCooldownTimer = 0.f;
+    timers.cancel(attackCooldownTimer);
     flightTimer = 0.f;
     tilemap.resetCollectibles();
     tilemap.resetPowerups();
+    tilemap.platforms.reset();
     reservePowerup.reset();
     setPlayerPowerState(PlayerPowerState::Small);
     respawnPlayer();
@@ -316,30 +480,270 @@ void EngineCore::loadLevel(int levelIndex) {
 void EngineCore::enterWorldMap() {
     gameState = GameState::WorldMap;
     updateWorldMapText();
+    requestLevelData(selectedLevelIndex);
+    redrawRequested = true;
 
 }
 
 
 void EngineCore::run() {
     sf::Clock clock;
+    if (!AllocationTracker::compiledIn && (trackAllocations || reportFrameAllocations)) {
+        Log::warning(LogCategory::General, "built without ENGINE_ALLOC_TRACKING; allocation counts will read 0");
+    }
+    if (trackAllocations) {
+        allocationFrames.reserve(maxAllocationFrames);
+        AllocationTracker::setEnabled(true);
+    }
 
     while (window.isOpen()) {
+        if (canIdleRender()) {
+            // Menus are static: sleep in the OS until something changes,
+            // then throw away the time spent blocked so dt stays small.
+            waitForEvents();
+            clock.restart();
+        }
         float dt = clock.restart().asSeconds();
 
+        assetLoader.pumpCompletions(sf::milliseconds(4));
+        if (!startupAssetsReported && assetLoader.isIdle()) {
+            startupAssetsReported = true;
+            Log::info(LogCategory::Assets, "background assets ready: %g ms",
+                startupClock.getElapsedTime().asMicroseconds() / 1000.0);
+        }
+        const std::uint64_t allocationsBefore = AllocationTracker::getAllocationCount();
+        AllocationTracker::beginFrame();
+        frameTimes.recordSeconds(dt);
         processEvents();
+        sf::Clock phaseClock;
         update(dt);
+        const sf::Time updateTime = phaseClock.restart();
+        updateTimes.record(static_cast<std::uint64_t>(updateTime.asMicroseconds()));
         render();
+        const sf::Time renderTime = phaseClock.getElapsedTime();
+        renderTimes.record(static_cast<std::uint64_t>(renderTime.asMicroseconds()));
+        // Update, draw and present, including rasterisation that a software
+        // GL driver defers to the swap; the limiter's sleep comes after.
+        if (gameState == GameState::Playing) {
+            updateDynamicRenderScale((updateTime + renderTime).asSeconds());
+        }
+        window.waitForFrameLimit();
+        frameArena.reset();
+        recordFrameAllocations(AllocationTracker::getAllocationCount() - allocationsBefore);
+        if (trackAllocations && allocationFrames.size() < maxAllocationFrames) {
+            allocationFrames.push_back({ dt, AllocationTracker::endFrame() });
+        }
+        Metrics::endTick();
+        if constexpr (Metrics::enabled) {
+            if (!metricsPath.empty() && metricsFlushClock.getElapsedTime().asSeconds() >= metricsFlushInterval) {
+                metricsFlushClock.restart();
+                Metrics::writeJson(metricsPath, startupClock.getElapsedTime().asSeconds());
+            }
+        }
+        redrawRequested = false;
+    }
+    if (trackAllocations) {
+        AllocationTracker::setEnabled(false);
+        writeAllocationProfile();
+    }
+    reportFrameStats();
+    if (!frameStatsPath.empty()) {
+        writeFrameStats();
+    }
+    if (!metricsPath.empty()) {
+        Metrics::writeJson(metricsPath, startupClock.getElapsedTime().asSeconds());
+    }
+}
+
+void EngineCore::reportFrameStats() const {
+    const auto milliseconds = [](std::uint64_t micros) {
+        return static_cast<double>(micros) / 1000.0;
+    };
+    const auto printRow = [&](const char* name, const FrameHistogram& histogram) {
+        std::cout << "  " << name
+            << " p50 " << milliseconds(histogram.percentile(0.50))
+            << " ms, p90 " << milliseconds(histogram.percentile(0.90))
+            << " ms, p99 " << milliseconds(histogram.percentile(0.99))
+            << " ms, max " << milliseconds(histogram.getMax()) << " ms\n";
+    };
+    // A hitch is a frame that took long enough to drop at least one more.
+    const std::uint64_t hitchMicros = static_cast<std::uint64_t>(targetFrameTime * 2.f * 1e6f);
+    const std::uint64_t severeMicros = static_cast<std::uint64_t>(severeHitchTime * 1e6f);
+    std::cout << "[frame stats] " << frameTimes.getCount() << " frames\n";
+    printRow("frame ", frameTimes);
+    printRow("update", updateTimes);
+    printRow("render", renderTimes);
+    std::cout << "  hitches: " << frameTimes.countAbove(hitchMicros) << " over "
+        << milliseconds(hitchMicros) << " ms, " << frameTimes.countAbove(severeMicros) << " over "
+        << milliseconds(severeMicros) << " ms\n";
+}
+
+// One row per non-empty bucket, so sessions can be merged or re-plotted.
+void EngineCore::writeFrameStats() const {
+    std::ofstream out(frameStatsPath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write frame stats: " << frameStatsPath << "\n";
+        return;
+    }
+    out << "histogram,lower_ms,upper_ms,count\n";
+    const auto writeRows = [&out](const char* name, const FrameHistogram& histogram) {
+        histogram.forEachBucket([&](std::uint64_t lower, std::uint64_t upper, std::uint64_t count) {
+            out << name << ',' << lower / 1000.0 << ',' << upper / 1000.0 << ',' << count << '\n';
+        });
+    };
+    writeRows("frame", frameTimes);
+    writeRows("update", updateTimes);
+    writeRows("render", renderTimes);
+}
+
+EngineCore::HeadlessLevelStats EngineCore::runHeadlessLevel(int levelIndex, int frames, float dt, int resetInterval) {
+    HeadlessLevelStats stats;
+    if (levels.empty()) {
+        return stats;
+    }
+    const int safeIndex = std::clamp(levelIndex, 0, static_cast<int>(levels.size()) - 1);
+    stats.file = levels[safeIndex].file;
+    stats.frameMilliseconds.reserve(static_cast<std::size_t>(std::max(frames, 0)));
+
+    // Textures and the atlas must be in place before entities are built, and
+    // the load is timed from the file, not from a prefetched parse.
+    assetLoader.finishAll();
+    preparedLevel.reset();
+    preparedLevelIndex = -1;
+    Input::setScripted(true);
+
+    sf::Clock clock;
+    loadLevel(safeIndex);
+    stats.loadMilliseconds = clock.getElapsedTime().asMicroseconds() / 1000.0;
+    gameState = GameState::Playing;
+    lives = 3;
+    gameOver = false;
+    paused = false;
+
+    std::uint64_t allocations = 0;
+    for (int frame = 0; frame < frames; ++frame) {
+        // Run right, jump in regular bursts, throw whenever powered up.
+        Input::setKey(sf::Keyboard::D, true);
+        Input::setKey(sf::Keyboard::LShift, true);
+        Input::setKey(sf::Keyboard::Space, frame % 75 < 18);
+        Input::setKey(sf::Keyboard::F, frame % 40 == 0);
+        Input::setKey(sf::Keyboard::R, resetInterval > 0 && frame % resetInterval == resetInterval - 1);
+
+        const std::uint64_t allocationsBefore = AllocationTracker::getAllocationCount();
+        clock.restart();
+        update(dt);
+        frameArena.reset();
+        Metrics::endTick();
+        stats.frameMilliseconds.push_back(clock.getElapsedTime().asMicroseconds() / 1000.f);
+        allocations += AllocationTracker::getAllocationCount() - allocationsBefore;
+
+        if (gameOver || gameState != GameState::Playing) {
+            ++stats.restarts;
+            loadLevel(safeIndex);
+            gameState = GameState::Playing;
+            lives = 3;
+            gameOver = false;
+        }
+    }
+    Input::setScripted(false);
+    stats.liveEntities = scene.getEntities().size();
+    if (frames > 0) {
+        stats.allocationsPerFrame = static_cast<double>(allocations) / frames;
+    }
+    Log::flush(); // keep gameplay logs ahead of the caller's report
+    return stats;
+}
+
+// One row per frame, with the frame time first so it lines up with other
+// per-frame timing captures.
+void EngineCore::writeAllocationProfile() const {
+    std::ofstream out(allocationProfilePath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Failed to write allocation profile: " << allocationProfilePath << "\n";
+        return;
+    }
+    out << "frame,frame_ms,allocations,bytes,live_bytes,peak_live_bytes";
+    for (std::size_t tag = 0; tag < AllocationTracker::tagCount; ++tag) {
+        const char* name = AllocationTracker::getTagName(static_cast<AllocationTag>(tag));
+        out << ',' << name << "_allocations," << name << "_bytes," << name << "_peak_live_bytes";
+    }
+    out << '\n';
+    for (std::size_t i = 0; i < allocationFrames.size(); ++i) {
+        const AllocationTracker::FrameStats& stats = allocationFrames[i].stats;
+        out << i << ',' << allocationFrames[i].frameTime * 1000.f << ',' << stats.allocations << ','
+            << stats.bytes << ',' << stats.liveBytes << ',' << stats.peakLiveBytes;
+        for (const AllocationTracker::TagStats& tag : stats.tags) {
+            out << ',' << tag.allocations << ',' << tag.bytes << ',' << tag.peakLiveBytes;
+        }
+        out << '\n';
+    }
+    std::cout << "[alloc] wrote " << allocationFrames.size() << " frames to " << allocationProfilePath << "\n";
+}
+
+void EngineCore::recordFrameAllocations(std::uint64_t allocations) {
+    if (!reportFrameAllocations || gameState != GameState::Playing || paused) {
+        frameAllocationFrames = 0;
+        frameAllocationTotal = 0;
+        frameAllocationPeak = 0;
+        frameAllocationClock.restart();
+        return;
+    }
+    ++frameAllocationFrames;
+    frameAllocationTotal += allocations;
+    frameAllocationPeak = std::max(frameAllocationPeak, allocations);
+    if (frameAllocationClock.getElapsedTime().asSeconds() < frameAllocationReportInterval) {
+        return;
+    }
+    Log::info(LogCategory::General,
+        "heap allocations per frame: avg %g, max %llu over %d frames; frame arena high water %zu / %zu bytes",
+        static_cast<double>(frameAllocationTotal) / frameAllocationFrames,
+        static_cast<unsigned long long>(frameAllocationPeak), frameAllocationFrames,
+        frameArena.getHighWater(), frameArena.getCapacity());
+    frameAllocationFrames = 0;
+    frameAllocationTotal = 0;
+    frameAllocationPeak = 0;
+    frameAllocationClock.restart();
+}
+
+bool EngineCore::canIdleRender() const {
+    if (!idleRenderEnabled || redrawRequested || !assetLoader.isIdle()) {
+        return false;
+    }
+    if (gameState == GameState::StartMenu) {
+        return !startTransition;
+    }
+    return gameState == GameState::WorldMap;
+}
+
+void EngineCore::waitForEvents() {
+    sf::Event event;
+    if (window.waitEvent(event)) {
+        handleEvent(event);
     }
 }
 
 void EngineCore::processEvents() {
     sf::Event event;
     while (window.pollEvent(event)) {
-        if (event.type == sf::Event::Closed) {
-            window.close();
+        handleEvent(event);
+    }
+}
 
-        }
+void EngineCore::handleEvent(const sf::Event& event) {
+    if (event.type == sf::Event::Closed) {
+        window.close();
+        return;
+
+    }
+    if (event.type == sf::Event::Resized
+        || event.type == sf::Event::GainedFocus
+        || event.type == sf::Event::MouseEntered) {
+        // SFML has no expose event; these are the cases where the OS may
+        // have discarded our back buffer.
+        redrawRequested = true;
+    }
     if (event.type == sf::Event::KeyPressed) {
+        redrawRequested = true;
         if (event.key.code == sf::Keyboard::Escape) {
             window.close();
 
@@ -355,12 +759,14 @@ void EngineCore::processEvents() {
             if (event.key.code == sf::Keyboard::Left) {
                 selectedLevelIndex = std::max(0, selectedLevelIndex - 1);
                 updateWorldMapText();
+                requestLevelData(selectedLevelIndex);
 
             }
             if (event.key.code == sf::Keyboard::Right) {
                 const int maxIndex = std::min(maxUnlockedLevelIndex, static_cast<int>(levels.size()) - 1);
                 selectedLevelIndex = std::min(maxIndex, selectedLevelIndex + 1);
                 updateWorldMapText();
+                requestLevelData(selectedLevelIndex);
             }
             if (event.key.code == sf::Keyboard::Enter) {
                 if (selectedLevelIndex <= maxUnlockedLevelIndex) {
@@ -370,13 +776,12 @@ void EngineCore::processEvents() {
                 }
             }
         }
+        if (event.key.code == sf::Keyboard::F9) {
+            reportFrameStats();
+        }
         if (gameState == GameState::Playing && event.key.code == sf::Keyboard::P) {
             paused = !paused;
-            std::cout << (!paused ? "Game paused\n" : "Game continue\n");
-
-        }
-
-         
+            Log::info(LogCategory::Input, paused ? "Game paused" : "Game continue");
         }
     }
 
@@ -419,7 +824,7 @@ void EngineCore::update(float dt) {
     
     
     
-    const bool resetPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::R);
+    const bool resetPressed = Input::isKeyPressed(sf::Keyboard::R);
     if (resetPressed && !resetHeld) {
         if (gameOver) {
             resetGameState();
@@ -441,19 +846,23 @@ void EngineCore::update(float dt) {
         return;
 
     }
-    const bool reservePressed = sf::Keyboard::isKeyPressed(sf::Keyboard::Q);
+    const bool reservePressed = Input::isKeyPressed(sf::Keyboard::Q);
     if (reservePressed && !reserveHeld) {
         handleReserveActivation();
     }
     reserveHeld = reservePressed;
 
     tilemap.update(dt);
-	updateInvincibility(dt);
+    particles.update(dt);
+    timers.advance(dt);
+	updateInvincibility();
     updatePowerupFlash(dt);
-    attackCooldownTimer = std::max(0.f, attackCooldownTimer - dt);
 
     if (playerDying) {
-        scene.update(dt);
+        {
+            AllocationScope allocationScope(AllocationTag::SceneUpdate);
+            scene.update(dt);
+        }
         updatePlayerDeath(dt);
         clampPlayerToLevel();
         updateCameraFollow();
@@ -461,38 +870,40 @@ void EngineCore::update(float dt) {
         return;
     }
     resetPlayerIfFallen();
+    handleHazardTiles();
     handleCollectibles();
     handlePowerups();
     handlePowerupActions(dt);
     checkGoalReached();
-    scene.update(dt);
+    {
+        AllocationScope allocationScope(AllocationTag::SceneUpdate);
+        scene.update(dt);
+    }
+    handleTileBumps();
     applyGlidePhysics();
     applyFlightPhysics(dt);
     clampPlayerToLevel();
     updateCameraFollow();
     clampCameraToLevel();
     handleEnemyCollisions();
-    if (levelComplete) {
-        goalMessageTimer -= dt;
-        if (goalMessageTimer <= 0.f) {
-            const int nextIndex = currentLevelIndex + 1;
-            if (nextIndex < static_cast<int>(levels.size())) {
-                maxUnlockedLevelIndex = std::max(maxUnlockedLevelIndex, nextIndex);
-                currentLevelIndex = nextIndex;
-                selectedLevelIndex = currentLevelIndex;
-            }
-            saveProgress();
-            enterWorldMap();
-
 
-        }
-    }
 
 
+}
 
+void EngineCore::finishLevel() {
+    const int nextIndex = currentLevelIndex + 1;
+    if (nextIndex < static_cast<int>(levels.size())) {
+        maxUnlockedLevelIndex = std::max(maxUnlockedLevelIndex, nextIndex);
+        currentLevelIndex = nextIndex;
+        selectedLevelIndex = currentLevelIndex;
+    }
+    saveProgress();
+    enterWorldMap();
 }
 
 void EngineCore::render() {
+    AllocationScope allocationScope(AllocationTag::EngineRender);
     window.beginDraw();
 
     // Camera view
@@ -500,7 +911,12 @@ void EngineCore::render() {
         renderPixelatedScene();
     }
     else if (gameState == GameState::Playing) {
-        renderScene(window.getRenderWindow());
+        if (renderScale > 1) {
+            renderDownscaledScene();
+        }
+        else {
+            renderScene(window.getRenderWindow());
+        }
     }
     else {
         window.getRenderWindow().clear(sf::Color::Black);
@@ -511,43 +927,20 @@ void EngineCore::render() {
 
     // Draw entities
     if (gameState == GameState::Playing) {
-        livesText.setString("Lives: " + std::to_string(lives));
-        coinText.setString("Coins: " + std::to_string(coinBank));
-        scoreText.setString("Score: " + std::to_string(score));
-        pauseText.setString(paused ? "Paused" : "");
-        levelText.setString(std::to_string(currentWorld) + "-" + std::to_string(currentLevel) + " World");
-        const sf::FloatRect levelBounds = levelText.getLocalBounds();
-        const sf::Vector2u windowSize = window.getRenderWindow().getSize();
-        levelText.setPosition(static_cast<float>(windowSize.x) - levelBounds.width - 16.f, 12.f);
-
-        if (goalMessageTimer > 0.f) {
-            goalText.setString("Goal reached!");
-            const sf::FloatRect bounds = goalText.getLocalBounds();
-            const sf::Vector2u  windowSize = window.getRenderWindow().getSize();
-            goalText.setOrigin(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f);
-            goalText.setPosition(static_cast<float>(windowSize.x) / 2.f, 100.f);
-            window.getRenderWindow().draw(goalText);
-        }
-        window.getRenderWindow().draw(coinText);
-        window.getRenderWindow().draw(scoreText);
-        window.getRenderWindow().draw(livesText);
-        window.getRenderWindow().draw(pauseText);
-        window.getRenderWindow().draw(levelText);
-        powerText.setString("Power: " + toPowerupLabel(currentPowerState));
-        const std::string reserveLabel = reservePowerup ? toPowerupLabel(*reservePowerup) : "Empty";
-        reserveText.setString("Reserve (Q): " + reserveLabel);
-        window.getRenderWindow().draw(powerText);
-        window.getRenderWindow().draw(reserveText);
-        controlsText.setString("Move: A/D Jump/Fly: Space Run: Shift Throw: F Reserve: Q Reset: R Pause: P");
-        window.getRenderWindow().draw(controlsText);
-
-        if (gameOver) {
-            gameOverText.setString("Gameover - Press R to Restart");
-            const sf::FloatRect bounds = gameOverText.getLocalBounds();
-            const sf::Vector2u windowSize = window.getRenderWindow().getSize();
-            gameOverText.setPosition(static_cast<float>(windowSize.x) / 2.f, 140.f);
-            window.getRenderWindow().draw(gameOverText);
-        }
+        hud.setNumber(livesField, "Lives: ", lives);
+        hud.setNumber(coinField, "Coins: ", coinBank);
+        hud.setNumber(scoreField, "Score: ", score);
+        FrameString levelText(frameArena.allocator<char>());
+        appendNumber(levelText, currentWorld);
+        levelText += '-';
+        appendNumber(levelText, currentLevel);
+        hud.setText(levelField, levelText, " World");
+        hud.setText(powerField, "Power: ", toPowerupLabel(currentPowerState));
+        hud.setText(reserveField, "Reserve (Q): ", reservePowerup ? toPowerupLabel(*reservePowerup) : "Empty");
+        hud.setVisible(pauseField, paused);
+        hud.setVisible(goalField, timers.pending(goalMessageTimer));
+        hud.setVisible(gameOverField, gameOver);
+        hud.render(window.getRenderWindow());
     }
 
     if (gameState == GameState::WorldMap) {
@@ -560,6 +953,7 @@ void EngineCore::render() {
         window.getRenderWindow().draw(worldMapTitleText);
         window.getRenderWindow().draw(worldMapPromptText);
         window.getRenderWindow().draw(worldMapLevelText);
+        Metrics::count(MetricCounter::DrawCalls, 3);
     }
     if (gameState == GameState::StartMenu && !startTransition) {
         const sf::FloatRect titleBounds = startMenuTitleText.getLocalBounds();
@@ -571,6 +965,7 @@ void EngineCore::render() {
         startMenuPromptText.setPosition(static_cast<float>(menuSize.x) / 2.f, 280.f);
         window.getRenderWindow().draw(startMenuTitleText);
         window.getRenderWindow().draw(startMenuPromptText);
+        Metrics::count(MetricCounter::DrawCalls, 2);
 
 
 
@@ -583,17 +978,26 @@ void EngineCore::render() {
         beginText.setOrigin(beginBounds.left + beginBounds.width / 2.f, beginBounds.top + beginBounds.height / 2.f);
         beginText.setPosition(static_cast<float>(windowSize.x) / 2.f, 220.f);
         window.getRenderWindow().draw(beginText);
+        Metrics::count(MetricCounter::DrawCalls);
     }
 
-
     window.endDraw();
 
 }
 void EngineCore::renderScene(sf::RenderTarget& target) {
     const sf::View previousView = target.getView();
     target.setView(camera);
-    tilemap.render(target);
+    {
+        AllocationScope allocationScope(AllocationTag::TilemapRender);
+        tilemap.renderBackground(target);
+        tilemap.render(target);
+    }
     scene.render(target);
+    particles.render(target);
+    {
+        AllocationScope allocationScope(AllocationTag::TilemapRender);
+        tilemap.renderForeground(target);
+    }
     target.setView(previousView);
 }
 
@@ -605,22 +1009,60 @@ void EngineCore::renderPixelatedScene() {
     const unsigned int textureWidth = std::max(1u, static_cast<unsigned int>(windowSize.x / pixelSize));
     const unsigned int textureHeight = std::max(1u, static_cast<unsigned int>(windowSize.y / pixelSize));
 
-    if (textureWidth != pixelateTextureSize.x || textureHeight != pixelateTextureSize.y) {
-        pixelateTexture.create(textureWidth, textureHeight);
+    renderSceneThroughTexture(
+        { textureWidth, textureHeight },
+        { static_cast<float>(windowSize.x) / static_cast<float>(textureWidth),
+          static_cast<float>(windowSize.y) / static_cast<float>(textureHeight) },
+        sf::Color::Black);
+}
+
+void EngineCore::renderDownscaledScene() {
+    // Integer upscale: every internal pixel covers exactly renderScale x
+    // renderScale window pixels, rounding the texture up to cover the edge.
+    const sf::Vector2u windowSize = window.getRenderWindow().getSize();
+    const unsigned int scale = static_cast<unsigned int>(renderScale);
+    const unsigned int textureWidth = std::max(1u, (windowSize.x + scale - 1) / scale);
+    const unsigned int textureHeight = std::max(1u, (windowSize.y + scale - 1) / scale);
+    const float scaleFactor = static_cast<float>(scale);
+    renderSceneThroughTexture({ textureWidth, textureHeight }, { scaleFactor, scaleFactor }, sf::Color(120, 180, 225));
+}
+
+void EngineCore::renderSceneThroughTexture(sf::Vector2u textureSize, sf::Vector2f upscale, sf::Color clearColor) {
+    if (textureSize.x != pixelateTextureSize.x || textureSize.y != pixelateTextureSize.y) {
+        pixelateTexture.create(textureSize.x, textureSize.y);
         pixelateTexture.setSmooth(false);
-        pixelateTextureSize = { textureWidth, textureHeight };
+        pixelateTextureSize = textureSize;
     }
 
-    pixelateTexture.clear(sf::Color::Black);
+    pixelateTexture.clear(clearColor);
     renderScene(pixelateTexture);
     pixelateTexture.display();
 
     pixelateSprite.setTexture(pixelateTexture.getTexture(), true);
     pixelateSprite.setPosition(0.f, 0.f);
-    pixelateSprite.setScale(
-        static_cast<float>(windowSize.x) / static_cast<float>(textureWidth),
-        static_cast<float>(windowSize.y) / static_cast<float>(textureHeight));
+    pixelateSprite.setScale(upscale);
     window.getRenderWindow().draw(pixelateSprite);
+    Metrics::count(MetricCounter::DrawCalls);
+}
+
+void EngineCore::updateDynamicRenderScale(float frameWorkTime) {
+    if (!dynamicRenderScale) {
+        return;
+    }
+    // Smooth over a few frames and wait between steps so a single hitch
+    // (level load, texture swap) doesn't make the scale oscillate.
+    frameWorkAverage += (frameWorkTime - frameWorkAverage) * 0.1f;
+    if (renderScaleStepClock.getElapsedTime().asSeconds() < renderScaleStepDelay) {
+        return;
+    }
+    if (frameWorkAverage > targetFrameTime && renderScale < maxRenderScale) {
+        ++renderScale;
+        renderScaleStepClock.restart();
+    }
+    else if (frameWorkAverage < targetFrameTime * 0.5f && renderScale > 1) {
+        --renderScale;
+        renderScaleStepClock.restart();
+    }
 }
 void EngineCore::updateCameraFollow() {
     if (!player) {
@@ -824,13 +1266,43 @@ void EngineCore::handleCollectibles() {
     if (collectedNow > 0) {
 
         collectedCoins = tilemap.getCollectedCount();
-        score += collectedNow * coinScoreValue;
-        coinBank += collectedNow;
-        while (coinBank >= 100) {
-            coinBank -= 100;
-            lives += 1;
-        }
-        std::cout << "Collected coin " << collectedCoins << " / " << tilemap.getCollectibleCount() << "\n";
+        awardCoins(collectedNow);
+        particles.emit(sf::Vector2f(bounds.left + bounds.width / 2.f, bounds.top + bounds.height / 2.f),
+            ParticleSystem::makeBurst(12 * collectedNow, sf::Color(255, 215, 0), 3.f, 150.f));
+        Log::info(LogCategory::Gameplay, "Collected coin %d / %d", collectedCoins, tilemap.getCollectibleCount());
+    }
+}
+void EngineCore::awardCoins(int count) {
+    score += count * coinScoreValue;
+    coinBank += count;
+    while (coinBank >= 100) {
+        coinBank -= 100;
+        lives += 1;
+    }
+}
+void EngineCore::handleTileBumps() {
+    if (!player)
+        return;
+
+    PhysicsComponent* physics = player->getComponent<PhysicsComponent>();
+    if (!physics || !physics->hitCeiling)
+        return;
+
+    const sf::Vector2i tile = physics->ceilingTile;
+    const float tileEdge = static_cast<float>(tilemap.tileSize);
+    const sf::Vector2f tileCenter((tile.x + 0.5f) * tileEdge, (tile.y + 0.5f) * tileEdge);
+    switch (tilemap.bumpTile(tile.x, tile.y, isPoweredState(currentPowerState))) {
+    case Tilemap::TileBump::Bumped:
+        awardCoins(1);
+        particles.emit(sf::Vector2f(tileCenter.x, tileCenter.y - tileEdge),
+            ParticleSystem::makeBurst(12, sf::Color(255, 215, 0), 3.f, 150.f));
+        break;
+    case Tilemap::TileBump::Broken:
+        score += brickScoreValue;
+        particles.emit(tileCenter, ParticleSystem::makeBurst(24, sf::Color(180, 90, 50), 5.f, 200.f));
+        break;
+    case Tilemap::TileBump::None:
+        break;
     }
 }
 void EngineCore::handlePowerups() {
@@ -856,20 +1328,20 @@ void EngineCore::handlePowerups() {
 }
 void EngineCore::handlePowerupActions(float dt) {
     (void)dt;
-    if (!player || attackCooldownTimer > 0.f) {
+    if (!player || timers.pending(attackCooldownTimer)) {
         return;
     }
-    const bool attackPressed = sf::Keyboard::isKeyPressed(sf::Keyboard::F);
+    const bool attackPressed = Input::isKeyPressed(sf::Keyboard::F);
     if (!attackPressed) {
         return;
     }
     if (currentPowerState == PlayerPowerState::FireFlower) {
         spawnProjectile(false);
-        attackCooldownTimer = fireballCooldown;
+        attackCooldownTimer = timers.schedule(fireballCooldown);
     }
     else if (currentPowerState == PlayerPowerState::HammerSuit) {
         spawnProjectile(true);
-        attackCooldownTimer = hammerCooldown;
+        attackCooldownTimer = timers.schedule(hammerCooldown);
     }
 }
 
@@ -890,10 +1362,13 @@ void EngineCore::checkGoalReached() {
 
     if (tilemap.reachedGoal(bounds)) {
         levelComplete = true;
-        goalMessageTimer = goalMessageDuration;
+        goalMessageTimer = timers.schedule(goalMessageDuration, [this] { finishLevel(); });
+        // finishLevel() selects the next level on the world map, so have it
+        // ready by the time the goal message is gone.
+        requestLevelData(std::min(currentLevelIndex + 1, static_cast<int>(levels.size()) - 1));
         score += goalScoreValue;
-        std::cout << "Goal reached! Coins collected: " << collectedCoins << " / "
-            << tilemap.getCollectibleCount() << "\n";
+        Log::info(LogCategory::Gameplay, "Goal reached! Coins collected: %d / %d",
+            collectedCoins, tilemap.getCollectibleCount());
 
         
     }
@@ -962,56 +1437,66 @@ void EngineCore::handleEnemyCollisions() {
         const bool stomp = playerBottom <= enemyTop + 5.f && playerPhysics->velocityY > 0.f;
 
         if (stomp) {
-            enemy->alive = false;
-            enemy->deathTimer = enemy->deathDelay;
-            if (PhysicsComponent* enemyPhysics = entity->getComponent<PhysicsComponent>()) {
-                enemyPhysics->velocityY = 0.f;
-                enemyPhysics->onGround = true;
-
-
-            }
-            if (SpriteComponent* sprite = entity->getComponent<SpriteComponent>()) {
-                const float currentXScale = sprite->getSprite().getScale().x;
-                sprite->getSprite().setScale(currentXScale, 0.25f);
-
-            }
-            if (AnimationComponent* anim = entity->getComponent<AnimationComponent>()) {
-                anim->paused = true;
-            }
+            particles.emit(sf::Vector2f(enemyBounds.left + enemyBounds.width / 2.f, enemyBounds.top),
+                ParticleSystem::makeBurst(16, sf::Color(150, 100, 60), 4.f, 120.f));
+            enemy->kill();
             playerPhysics->velocityY = -250.f;
             playerPhysics->onGround = false;
 
         }
         else {
-            if (invincible) {
-                continue;
-            }
-            if (isPoweredState(currentPowerState)) {
-                setPlayerPowerState(PlayerPowerState::Small);
-                invincible = true;
-                invincibilityTimer = invincibilityDuration;
-
-            }
-            else {
-                loseLife();
-            }
+            damagePlayer();
         }
     }
 
 }
+void EngineCore::damagePlayer() {
+    if (invincible) {
+        return;
+    }
+    if (isPoweredState(currentPowerState)) {
+        setPlayerPowerState(PlayerPowerState::Small);
+        startInvincibility(invincibilityDuration);
+
+    }
+    else {
+        loseLife();
+    }
+}
+void EngineCore::handleHazardTiles() {
+    if (!player)
+        return;
+
+    TransformComponent* transform = player->getComponent<TransformComponent>();
+    MovementComponent* movement = player->getComponent<MovementComponent>();
+    if (!transform)
+        return;
+
+    const float width = movement ? movement->colliderWidth : 32.f;
+    const float height = movement ? movement->colliderHeight : 48.f;
+    const sf::FloatRect bounds(transform->position.x, transform->position.y, width, height);
+    // Grow by a pixel so standing on top of spikes counts as touching them.
+    const sf::FloatRect probe(bounds.left, bounds.top, bounds.width, bounds.height + 1.f);
+    if (tilemap.queryOverlap(probe, Tilemap::TileFlag::Hazard).hit) {
+        damagePlayer();
+    }
+}
 void EngineCore::resetLevelState() {
     levelComplete = false;
-    goalMessageTimer = 0.f;
+    timers.cancel(goalMessageTimer);
     collectedCoins = 0;
     coinBank = 0;
     playerDying = false;
     invincible = false;
-    invincibilityTimer = 0.f;
+    timers.cancel(invincibilityTimer);
     powerupFlashTimer = 0.f;
-    attackCooldownTimer = 0.f;
+    timers.cancel(attackCooldownTimer);
     flightTimer = 0.f;
     tilemap.resetCollectibles();
     tilemap.resetPowerups();
+    tilemap.resetTileEdits();
+    tilemap.platforms.reset();
+    particles.clear();
     reservePowerup.reset();
     setPlayerPowerState(PlayerPowerState::Small);
     if (player) {
@@ -1029,25 +1514,28 @@ void EngineCore::resetLevelState() {
     respawnPlayer();
 
 }
-void EngineCore::updateInvincibility(float dt) {
-    if (!invincible)
-        return;
-    invincibilityTimer = std::max(0.f, invincibilityTimer - dt);
-    if (invincibilityTimer <= 0.f) {
-        invincible = false;
-        if (player) {
-            if (SpriteComponent* sprite = player->getComponent<SpriteComponent>()) {
-                sprite->getSprite().setColor(sf::Color(255, 255, 255, 255));
-            }
-        }
-    }
-    else if (player) {
+void EngineCore::startInvincibility(float duration) {
+    invincible = true;
+    timers.cancel(invincibilityTimer);
+    invincibilityTimer = timers.schedule(duration, [this] { endInvincibility(); });
+}
+void EngineCore::endInvincibility() {
+    invincible = false;
+    if (player) {
         if (SpriteComponent* sprite = player->getComponent<SpriteComponent>()) {
-            const float alpha = (static_cast<int>(invincibilityTimer * 10.f) % 2 == 0) ? 120.f : 255.f;
-            sprite->getSprite().setColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(alpha)));
+            sprite->getSprite().setColor(sf::Color(255, 255, 255, 255));
         }
     }
 }
+void EngineCore::updateInvincibility() {
+    if (!invincible || !player)
+        return;
+    if (SpriteComponent* sprite = player->getComponent<SpriteComponent>()) {
+        const float remaining = timers.remaining(invincibilityTimer);
+        const float alpha = (static_cast<int>(remaining * 10.f) % 2 == 0) ? 120.f : 255.f;
+        sprite->getSprite().setColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(alpha)));
+    }
+}
 
 void EngineCore::updatePowerupFlash(float dt) {
     if (powerupFlashTimer <= 0.f || !player) {
@@ -1095,13 +1583,12 @@ void EngineCore::loseLife() {
     if (invincible || gameOver || playerDying)
         return;
     lives = std::max(0, lives - 1);
-    invincible = true;
-    invincibilityTimer = invincibilityDuration;
+    startInvincibility(invincibilityDuration);
 
     if (lives <= 0) {
         gameOver = true;
         invincible = false;
-        invincibilityTimer = 0.f;
+        timers.cancel(invincibilityTimer);
         if (player) {
             if (SpriteComponent* sprite = player->getComponent<SpriteComponent>()) {
                 sprite->getSprite().setColor(sf::Color(255, 255, 255, 255));
@@ -1120,9 +1607,9 @@ void EngineCore::resetGameState() {
     paused = false;
     playerDying = false;
     invincible = false;
-    invincibilityTimer = 0.f;
+    timers.cancel(invincibilityTimer);
     powerupFlashTimer = 0.f;
-    attackCooldownTimer = 0.f;
+    timers.cancel(attackCooldownTimer);
     flightTimer = 0.f;
     currentLevelIndex = 0;
     maxUnlockedLevelIndex = 0;
@@ -1176,10 +1663,10 @@ void EngineCore::setPlayerPowerState(PlayerPowerState powerState) {
     float textureScaleY = 1.f;
 
     if (sprite) {
-        const std::vector<std::string> candidates = getPlayerSpriteCandidates(powerState);
+        const std::vector<std::string> candidates = assetIndex.filterExisting(getPlayerSpriteCandidates(powerState));
         bool updatedTexture = false;
         for (const auto& path : candidates) {
-            if (sprite->setTexture(path)) {
+            if (setSpriteSource(sprite, path)) {
                 updatedTexture = true;
                 if (animation) {
                     animation->refreshFromTexture();
@@ -1190,7 +1677,7 @@ void EngineCore::setPlayerPowerState(PlayerPowerState powerState) {
             }
         }
         if (!updatedTexture && powerState != PlayerPowerState::Small) {
-            if (sprite->setTexture("Assets/player.png") && animation) {
+            if (setSpriteSource(sprite, "Assets/player.png") && animation) {
                 animation->refreshFromTexture();
                 textureScaleX = animation->getTextureScaleX();
                 textureScaleY = animation->getTextureScaleY();
@@ -1218,8 +1705,7 @@ void EngineCore::setPlayerPowerState(PlayerPowerState powerState) {
         flightTimer = 0.f;
     }
     if (currentPowerState == PlayerPowerState::TanookiSuit) {
-        invincible = true;
-        invincibilityTimer = tanookiInvincibilityDuration;
+        startInvincibility(tanookiInvincibilityDuration);
     }
 
 }
@@ -1306,7 +1792,7 @@ void EngineCore::applyGlidePhysics() {
     if (!physics || physics->onGround) {
         return;
     }
-    const bool glideHeld = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+    const bool glideHeld = Input::isKeyPressed(sf::Keyboard::Space);
     if (!glideHeld || physics->velocityY <= 0.f) {
         return;
     }
@@ -1332,7 +1818,7 @@ void EngineCore::applyFlightPhysics(float dt) {
     if (flightTimer <= 0.f) {
         return;
     }
-    const bool flyHeld = sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+    const bool flyHeld = Input::isKeyPressed(sf::Keyboard::Space);
     if (!flyHeld) {
         return;
     }
@@ -1341,6 +1827,7 @@ void EngineCore::applyFlightPhysics(float dt) {
 }
 
 void EngineCore::spawnProjectile(bool isHammer) {
+    AllocationScope allocationScope(AllocationTag::SpawnProjectile);
     if (!player) {
         return;
     }
@@ -1366,14 +1853,24 @@ void EngineCore::spawnProjectile(bool isHammer) {
         ? "Assets/powerups/Hammersuit.png"
         : "Assets/powerups/Fireflower.png";
     SpriteComponent* projectileSprite =
-        projectile->addComponent<SpriteComponent>(texturePath, projectileTransform);
-
-    if (const sf::Texture* texture = projectileSprite->getSprite().getTexture()) {
-        const sf::Vector2u size = texture->getSize();
+        addSpriteComponent(projectile, texturePath, projectileTransform);
+
+    if (projectileSprite->getSprite().getTexture()) {
+        // Atlas icons are trimmed; scale and center on the untrimmed size so
+        // the projectile looks the same either way.
+        const sf::IntRect region = projectileSprite->getTextureRegion();
+        sf::Vector2i size(region.width, region.height);
+        sf::Vector2i trimOffset(0, 0);
+        if (const TextureAtlas::Region* atlasRegion = spriteAtlas.find(texturePath)) {
+            size = atlasRegion->sourceSize;
+            trimOffset = atlasRegion->trimOffset;
+        }
         if (size.x > 0 && size.y > 0) {
-            projectileSprite->frameWidth = static_cast<int>(size.x);
-            projectileSprite->frameHeight = static_cast<int>(size.y);
-            projectileSprite->getSprite().setOrigin(size.x / 2.f, size.y / 2.f);
+            projectileSprite->frameWidth = size.x;
+            projectileSprite->frameHeight = size.y;
+            projectileSprite->getSprite().setOrigin(
+                size.x / 2.f - static_cast<float>(trimOffset.x),
+                size.y / 2.f - static_cast<float>(trimOffset.y));
             const float scaleX = projectileSize / static_cast<float>(size.x);
             const float scaleY = projectileSize / static_cast<float>(size.y);
             projectileSprite->getSprite().setScale(direction < 0.f ? -scaleX : scaleX, scaleY);
@@ -1393,7 +1890,8 @@ void EngineCore::spawnProjectile(bool isHammer) {
         projectileSize,
         projectileSize,
         projectileLifetime,
-        projectileGravity);
+        projectileGravity,
+        &particles);
 }
 
 EngineCore::PlayerPowerState EngineCore::toPlayerPowerState(Tilemap::PowerupType powerupType) {
@@ -1414,7 +1912,7 @@ EngineCore::PlayerPowerState EngineCore::toPlayerPowerState(Tilemap::PowerupType
     }
 }
 
-std::string EngineCore::toPowerupLabel(PlayerPowerState powerState) {
+const char* EngineCore::toPowerupLabel(PlayerPowerState powerState) {
     switch (powerState) {
     case PlayerPowerState::Small:
         return "Small";
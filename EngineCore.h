@@ -2,13 +2,26 @@
 #include "Window.h"
 #include "Scene.h"
 #include "Tilemap.h"
+#include "Hud.h"
+#include "AssetLoader.h"
+#include "AssetIndex.h"
+#include "TextureAtlas.h"
+#include "ParticleSystem.h"
+#include "TimerWheel.h"
+#include "FrameArena.h"
+#include "AllocationTracker.h"
+#include "FrameHistogram.h"
+#include "Metrics.h"
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <optional>
 
 
+class SpriteComponent;
+class TransformComponent;
 
 class EngineCore {
 public:
@@ -32,7 +45,9 @@ public:
         HammerSuit,
         FrogSuit
     };
-    EngineCore();
+    // A headless engine never opens a window or plays music and does not
+    // touch save.dat; it is driven through runHeadlessLevel().
+    explicit EngineCore(bool headless = false);
     Tilemap tilemap;
     Entity* player = nullptr;
     sf::Vector2f playerSpawn{ 100.f, 100.f };
@@ -55,23 +70,80 @@ public:
     int currentLevelIndex = 0;
     int selectedLevelIndex = 0;
     int maxUnlockedLevelIndex = 0;
+    // Gameplay is drawn at window size / renderScale and upscaled by an
+    // integer factor. Dynamic mode steps the scale to hold targetFrameTime.
+    static constexpr int maxRenderScale = 4;
+    int renderScale = 1;
+    bool dynamicRenderScale = false;
+    float targetFrameTime = 1.f / 60.f;
+    // Logs heap allocations per frame during gameplay every few seconds.
+    // Both need a build with ENGINE_ALLOC_TRACKING=1.
+    bool reportFrameAllocations = false;
+    // Charges allocations to subsystem tags and writes a per-frame CSV on exit.
+    bool trackAllocations = false;
+    std::string allocationProfilePath = "alloc_profile.csv";
+    // Frame/update/render percentiles are printed on exit and on F9; when
+    // set, the histogram buckets are also written here as CSV on exit.
+    std::string frameStatsPath;
+    // When set, counters and gauges are written here as JSON every few
+    // seconds and on exit.
+    std::string metricsPath;
 
+    struct HeadlessLevelStats {
+        std::string file;
+        double loadMilliseconds = 0.0;
+        std::vector<float> frameMilliseconds; // update time per simulated frame
+        double allocationsPerFrame = 0.0;    // 0 without ENGINE_ALLOC_TRACKING
+        int restarts = 0;                     // game overs and finished runs that reloaded the level
+        std::size_t liveEntities = 0;         // scene size after the last frame
+
+        // Nearest-rank percentile of frameMilliseconds-style samples.
+        static double percentile(std::vector<float> samples, double fraction) {
+            if (samples.empty()) {
+                return 0.0;
+            }
+            const std::size_t index = std::min(samples.size() - 1,
+                static_cast<std::size_t>(fraction * static_cast<double>(samples.size())));
+            std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+            return samples[index];
+        }
+    };
+    // Loads a level and plays it for a fixed number of frames at a fixed dt
+    // with a scripted run-and-jump input, timing every update. No rendering.
+    // A non-zero resetInterval also presses R (level reset) that often.
+    HeadlessLevelStats runHeadlessLevel(int levelIndex, int frames, float dt, int resetInterval = 0);
+    int getLevelCount() const {
+        return static_cast<int>(levels.size());
+    }
 
 private:
+    bool headless = false;
+    sf::Clock startupClock;  // Declared before window so its creation is timed
+    bool startupAssetsReported = false;
     Window window;   // Our new window system!
+    TimerWheel timers; // Declared before scene: enemy components cancel their timers on destruction
     Scene scene;  // The scene managing entities
+    AssetIndex assetIndex;
+    AssetLoader assetLoader;
+    TextureAtlas spriteAtlas;
+    ParticleSystem particles;
+    FrameArena frameArena; // transient per-tick data; reset at the end of every frame
+    std::optional<Tilemap::LevelData> preparedLevel;
+    int preparedLevelIndex = -1;
+    int requestedLevelIndex = -1;
  
     sf::Font uiFont;
-    sf::Text coinText;
-    sf::Text scoreText;
-    sf::Text livesText;
-    sf::Text pauseText;
-    sf::Text goalText;
-    sf::Text gameOverText;
-    sf::Text controlsText;
-    sf::Text powerText;
-    sf::Text reserveText;
-    sf::Text levelText;
+    Hud hud;
+    std::size_t livesField = 0;
+    std::size_t coinField = 0;
+    std::size_t scoreField = 0;
+    std::size_t pauseField = 0;
+    std::size_t goalField = 0;
+    std::size_t gameOverField = 0;
+    std::size_t controlsField = 0;
+    std::size_t powerField = 0;
+    std::size_t reserveField = 0;
+    std::size_t levelField = 0;
     sf::Text startMenuTitleText;
     sf::Text startMenuPromptText;
     sf::Text beginText;
@@ -81,15 +153,36 @@ private:
     sf::RenderTexture pixelateTexture;
     sf::Sprite pixelateSprite;
     sf::Vector2u pixelateTextureSize{ 0, 0 };
+    const float renderScaleStepDelay = 0.5f;
+    float frameWorkAverage = 0.f;
+    sf::Clock renderScaleStepClock;
+    std::uint64_t frameAllocationTotal = 0;
+    std::uint64_t frameAllocationPeak = 0;
+    int frameAllocationFrames = 0;
+    const float frameAllocationReportInterval = 5.f;
+    sf::Clock frameAllocationClock;
+    struct AllocationFrame {
+        float frameTime = 0.f;
+        AllocationTracker::FrameStats stats;
+    };
+    std::vector<AllocationFrame> allocationFrames;
+    const std::size_t maxAllocationFrames = 60 * 60 * 10;
+    FrameHistogram frameTimes;
+    FrameHistogram updateTimes;
+    FrameHistogram renderTimes;
+    const float severeHitchTime = 0.1f;
+    const float metricsFlushInterval = 5.f;
+    sf::Clock metricsFlushClock;
     sf::Music backgroundMusic;
-    float goalMessageTimer = 0.f;
+    TimerWheel::Handle goalMessageTimer;
     const float goalMessageDuration = 2.5f;
     bool invincible = false;
-	float invincibilityTimer = 0.f;
+	TimerWheel::Handle invincibilityTimer;
 	const float invincibilityDuration = 1.5f;
     PlayerPowerState currentPowerState = PlayerPowerState::Small;
     std::optional<PlayerPowerState> reservePowerup;
     const int coinScoreValue = 100;
+    const int brickScoreValue = 50;
     const int goalScoreValue = 500;
     const int powerupScoreValue = 1000;
     const float smallColliderHeight = 48.f;
@@ -114,6 +207,9 @@ private:
     float startTransitionTimer = 0.f;
     const float startTransitionDuration = 1.2f;
     const float beginTextDuration = 0.5f;
+    // StartMenu/WorldMap only redraw on input or exposure when enabled.
+    bool idleRenderEnabled = true;
+    bool redrawRequested = true;
     std::vector<LevelInfo> levels;
 
 
@@ -123,16 +219,34 @@ private:
 
 
     void processEvents();
+    void handleEvent(const sf::Event& event);
+    void waitForEvents();
+    bool canIdleRender() const;
     void update(float dt);
     void render();
     void renderScene(sf::RenderTarget& target);
     void renderPixelatedScene();
+    void renderDownscaledScene();
+    void renderSceneThroughTexture(sf::Vector2u textureSize, sf::Vector2f upscale, sf::Color clearColor);
+    void updateDynamicRenderScale(float frameWorkTime);
+    void recordFrameAllocations(std::uint64_t allocations);
+    void writeAllocationProfile() const;
+    void reportFrameStats() const;
+    void writeFrameStats() const;
     void setupLevelList();
     void loadLevel(int levelIndex);
     void enterWorldMap();
     void updateWorldMapText();
     void saveProgress();
     void loadProgress();
+    void setupHud();
+    void requestStartupAssets();
+    void requestUnpackedAssets();
+    void requestTileProperties(const std::string& tilesetPath);
+    std::vector<TextureAtlas::Source> collectAtlasSources() const;
+    SpriteComponent* addSpriteComponent(Entity* entity, const std::string& path, TransformComponent* transform);
+    bool setSpriteSource(SpriteComponent* sprite, const std::string& path);
+    void requestLevelData(int levelIndex);
 
 
     void clampCameraToLevel();
@@ -146,8 +260,15 @@ private:
     void handlePowerups();
     void handleReserveActivation();
     void checkGoalReached();
+    void finishLevel();
     void handleEnemyCollisions();
-    void updateInvincibility(float dt);
+    void handleHazardTiles();
+    void handleTileBumps();
+    void awardCoins(int count);
+    void damagePlayer();
+    void startInvincibility(float duration);
+    void endInvincibility();
+    void updateInvincibility();
     void updatePowerupFlash(float dt);
     void loseLife();
     void resetLevelState();
@@ -160,9 +281,9 @@ private:
     void handlePowerupActions(float dt);
     void spawnProjectile(bool isHammer);
     static PlayerPowerState toPlayerPowerState(Tilemap::PowerupType powerupType);
-    static std::string toPowerupLabel(PlayerPowerState powerState);
+    static const char* toPowerupLabel(PlayerPowerState powerState);
     static bool isPoweredState(PlayerPowerState powerState);
-    float attackCooldownTimer = 0.f;
+    TimerWheel::Handle attackCooldownTimer;
     const float fireballCooldown = 0.35f;
     const float hammerCooldown = 0.5f;
     const float fireballSpeed = 420.f;
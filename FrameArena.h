@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+// Bump allocator for data that only lives until the end of the current tick.
+// Allocation is a pointer bump, individual frees are no-ops and reset() drops
+// everything at once. Requests that overflow the block go to spill blocks,
+// which are released on reset() and folded into a larger block, so after a
+// few frames steady-state use no longer touches the heap.
+class FrameArena {
+public:
+    template <typename T>
+    class Allocator {
+    public:
+        using value_type = T;
+
+        explicit Allocator(FrameArena& arena) noexcept
+            : arena(&arena) {
+        }
+
+        template <typename U>
+        Allocator(const Allocator<U>& other) noexcept
+            : arena(other.arena) {
+        }
+
+        T* allocate(std::size_t count) {
+            return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) noexcept {
+        }
+
+        template <typename U>
+        bool operator==(const Allocator<U>& other) const noexcept {
+            return arena == other.arena;
+        }
+
+        template <typename U>
+        bool operator!=(const Allocator<U>& other) const noexcept {
+            return arena != other.arena;
+        }
+
+    private:
+        template <typename U>
+        friend class Allocator;
+
+        FrameArena* arena;
+    };
+
+    explicit FrameArena(std::size_t capacity = 64 * 1024)
+        : block(std::max<std::size_t>(capacity, 1)) {
+    }
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) {
+        const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.data());
+        const std::uintptr_t aligned = (base + offset + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+        const std::size_t start = static_cast<std::size_t>(aligned - base);
+        if (start + bytes <= block.size()) {
+            offset = start + bytes;
+            highWater = std::max(highWater, offset);
+            return block.data() + start;
+        }
+        // Over-allocate so the spill can honour any alignment.
+        spills.emplace_back(new unsigned char[bytes + alignment]);
+        spilledBytes += bytes + alignment;
+        const std::uintptr_t spill = reinterpret_cast<std::uintptr_t>(spills.back().get());
+        return reinterpret_cast<void*>((spill + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1));
+    }
+
+    template <typename T>
+    Allocator<T> allocator() {
+        return Allocator<T>(*this);
+    }
+
+    // Invalidates everything allocated since the last reset.
+    void reset() {
+        if (!spills.empty()) {
+            const std::size_t needed = std::max(block.size(), highWater + spilledBytes);
+            spills.clear();
+            spilledBytes = 0;
+            block.assign(needed + needed / 2, 0);
+        }
+        offset = 0;
+    }
+
+    std::size_t getUsed() const {
+        return offset + spilledBytes;
+    }
+
+    std::size_t getCapacity() const {
+        return block.size();
+    }
+
+    std::size_t getHighWater() const {
+        return highWater;
+    }
+
+private:
+    std::vector<unsigned char> block;
+    std::size_t offset = 0;
+    std::size_t highWater = 0;
+    std::vector<std::unique_ptr<unsigned char[]>> spills;
+    std::size_t spilledBytes = 0;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameArena::Allocator<T>>;
+using FrameString = std::basic_string<char, std::char_traits<char>, FrameArena::Allocator<char>>;
@@ -0,0 +1,131 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+
+// Fixed-size log-linear histogram of durations in microseconds, in the style
+// of HdrHistogram: every power-of-two range is split into 64 linear
+// sub-buckets, so any recorded value is reported within 1.6% whatever its
+// magnitude. Recording is an index computation and an increment; nothing is
+// allocated, so it can run every frame for a whole session.
+class FrameHistogram {
+public:
+    // Values up to ~67 s are bucketed; anything longer lands in the last bucket.
+    static constexpr int subBucketBits = 7;
+    static constexpr std::uint32_t subBucketCount = 1u << subBucketBits;
+    static constexpr std::uint32_t subBucketHalf = subBucketCount / 2;
+    static constexpr int maxValueBits = 26;
+    static constexpr std::size_t bucketCount =
+        subBucketCount + (maxValueBits - subBucketBits) * subBucketHalf;
+
+    void record(std::uint64_t micros) {
+        ++counts[indexOf(micros)];
+        ++total;
+        maxValue = std::max(maxValue, micros);
+    }
+
+    void recordSeconds(float seconds) {
+        record(static_cast<std::uint64_t>(std::max(0.f, seconds) * 1e6f + 0.5f));
+    }
+
+    void clear() {
+        counts.fill(0);
+        total = 0;
+        maxValue = 0;
+    }
+
+    std::uint64_t getCount() const {
+        return total;
+    }
+
+    std::uint64_t getMax() const {
+        return maxValue;
+    }
+
+    // Smallest bucketed value v such that at least fraction of the samples
+    // are <= v; reported as the bucket midpoint, capped by the exact max.
+    std::uint64_t percentile(double fraction) const {
+        if (total == 0) {
+            return 0;
+        }
+        const double wanted = std::ceil(std::clamp(fraction, 0.0, 1.0) * static_cast<double>(total));
+        const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(wanted));
+        std::uint64_t seen = 0;
+        for (std::size_t index = 0; index < bucketCount; ++index) {
+            seen += counts[index];
+            if (seen >= rank) {
+                if (index == bucketCount - 1) {
+                    return maxValue; // overflow bucket has no meaningful midpoint
+                }
+                const std::uint64_t low = lowerBound(index);
+                const std::uint64_t mid = low + (upperBound(index) - low) / 2;
+                return std::min(mid, maxValue);
+            }
+        }
+        return maxValue;
+    }
+
+    // Samples in buckets that lie entirely above threshold; exact at bucket
+    // granularity, which is all a hitch count needs.
+    std::uint64_t countAbove(std::uint64_t thresholdMicros) const {
+        std::uint64_t count = 0;
+        for (std::size_t index = indexOf(thresholdMicros) + 1; index < bucketCount; ++index) {
+            count += counts[index];
+        }
+        return count;
+    }
+
+    // Iterates non-empty buckets as (lowerMicros, upperMicros, count).
+    template <typename Visitor>
+    void forEachBucket(Visitor visit) const {
+        for (std::size_t index = 0; index < bucketCount; ++index) {
+            if (counts[index] != 0) {
+                visit(lowerBound(index), upperBound(index), counts[index]);
+            }
+        }
+    }
+
+private:
+    std::array<std::uint64_t, bucketCount> counts{};
+    std::uint64_t total = 0;
+    std::uint64_t maxValue = 0;
+
+    static int highestBit(std::uint64_t value) {
+        int bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+    }
+
+    // Values below subBucketCount map one to one; above that, each power of
+    // two contributes subBucketHalf buckets of width 2^shift.
+    static std::size_t indexOf(std::uint64_t value) {
+        if (value < subBucketCount) {
+            return static_cast<std::size_t>(value);
+        }
+        const int shift = highestBit(value) - (subBucketBits - 1);
+        const std::size_t index = subBucketCount + static_cast<std::size_t>(shift - 1) * subBucketHalf
+            + static_cast<std::size_t>((value >> shift) - subBucketHalf);
+        return std::min(index, bucketCount - 1);
+    }
+
+    static std::uint64_t lowerBound(std::size_t index) {
+        if (index < subBucketCount) {
+            return index;
+        }
+        const std::size_t offset = index - subBucketCount;
+        const int shift = static_cast<int>(offset / subBucketHalf) + 1;
+        return (subBucketHalf + offset % subBucketHalf) << shift;
+    }
+
+    // Exclusive.
+    static std::uint64_t upperBound(std::size_t index) {
+        if (index < subBucketCount) {
+            return index + 1;
+        }
+        const int shift = static_cast<int>((index - subBucketCount) / subBucketHalf) + 1;
+        return lowerBound(index) + (std::uint64_t(1) << shift);
+    }
+};
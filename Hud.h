@@ -0,0 +1,296 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include "Logger.h"
+#include "Metrics.h"
+
+// Heads-up display drawn from one baked glyph atlas in a single draw call.
+// Every field owns a fixed slot of vertices in a shared array; a field is only
+// re-laid-out when its value actually changes.
+class Hud {
+public:
+    enum class Align {
+        Left,
+        Right,
+        Center
+    };
+
+    std::size_t addField(sf::Vector2f anchor, unsigned int characterSize, sf::Color color,
+        Align align = Align::Left, std::size_t capacity = 32) {
+        Field field;
+        field.anchor = anchor;
+        field.characterSize = characterSize;
+        field.color = color;
+        field.align = align;
+        field.capacity = capacity;
+        field.firstVertex = vertices.getVertexCount();
+        fields.push_back(field);
+        vertices.resize(field.firstVertex + capacity * verticesPerGlyph);
+        return fields.size() - 1;
+    }
+
+    // Rasterizes the printable ASCII range for every character size used by a
+    // field and packs it into one texture. Call after all fields are added.
+    bool bakeAtlas(const sf::Font& font) {
+        glyphSets.clear();
+        for (const Field& field : fields) {
+            if (!findGlyphSet(field.characterSize)) {
+                GlyphSet set;
+                set.characterSize = field.characterSize;
+                glyphSets.push_back(set);
+            }
+        }
+
+        const unsigned int atlasWidth = 512;
+        const unsigned int padding = 1;
+        unsigned int penX = padding;
+        unsigned int penY = padding;
+        unsigned int rowHeight = 0;
+        for (GlyphSet& set : glyphSets) {
+            for (sf::Uint32 c = firstGlyph; c <= lastGlyph; ++c) {
+                const sf::Glyph& glyph = font.getGlyph(c, set.characterSize, false);
+                GlyphInfo& info = set.glyphs[c - firstGlyph];
+                info.advance = glyph.advance;
+                info.bounds = glyph.bounds;
+                info.sourceRect = glyph.textureRect;
+                const unsigned int w = static_cast<unsigned int>(glyph.textureRect.width);
+                const unsigned int h = static_cast<unsigned int>(glyph.textureRect.height);
+                if (penX + w + padding > atlasWidth) {
+                    penX = padding;
+                    penY += rowHeight + padding;
+                    rowHeight = 0;
+                }
+                info.atlasRect = sf::IntRect(static_cast<int>(penX), static_cast<int>(penY),
+                    static_cast<int>(w), static_cast<int>(h));
+                penX += w + padding;
+                rowHeight = std::max(rowHeight, h);
+            }
+            set.lineSpacing = font.getLineSpacing(set.characterSize);
+        }
+
+        sf::Image atlasImage;
+        atlasImage.create(atlasWidth, std::max(1u, penY + rowHeight + padding), sf::Color::Transparent);
+        for (const GlyphSet& set : glyphSets) {
+            // Copy the font page only after every glyph of this size has been
+            // requested, since requesting glyphs can grow the page.
+            const sf::Image page = font.getTexture(set.characterSize).copyToImage();
+            for (const GlyphInfo& info : set.glyphs) {
+                if (info.atlasRect.width <= 0 || info.atlasRect.height <= 0)
+                    continue;
+                atlasImage.copy(page,
+                    static_cast<unsigned int>(info.atlasRect.left),
+                    static_cast<unsigned int>(info.atlasRect.top),
+                    info.sourceRect);
+            }
+        }
+        if (!atlasTexture.loadFromImage(atlasImage)) {
+            Log::error(LogCategory::Assets, "Failed to create HUD glyph atlas");
+            atlasReady = false;
+            return false;
+        }
+        atlasReady = true;
+        atlasTextureMetric.set(atlasTexture);
+        for (Field& field : fields) {
+            field.dirty = true;
+        }
+        return true;
+    }
+
+    void setText(std::size_t index, std::string_view prefix, std::string_view value = std::string_view()) {
+        Field& field = fields[index];
+        const std::size_t total = prefix.size() + value.size();
+        if (field.text.size() == total
+            && field.text.compare(0, prefix.size(), prefix) == 0
+            && field.text.compare(prefix.size(), value.size(), value) == 0) {
+            return;
+        }
+        field.text.assign(prefix);
+        field.text.append(value);
+        field.hasNumber = false;
+        field.dirty = true;
+    }
+
+    void setNumber(std::size_t index, std::string_view prefix, int value) {
+        Field& field = fields[index];
+        if (field.hasNumber && field.number == value)
+            return;
+        char digits[16];
+        const auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        setText(index, prefix, std::string_view(digits, static_cast<std::size_t>(end - digits)));
+        field.hasNumber = true;
+        field.number = value;
+    }
+
+    void setVisible(std::size_t index, bool visible) {
+        Field& field = fields[index];
+        if (field.visible == visible)
+            return;
+        field.visible = visible;
+        field.dirty = true;
+    }
+
+    void setAnchor(std::size_t index, sf::Vector2f anchor) {
+        Field& field = fields[index];
+        if (field.anchor == anchor)
+            return;
+        field.anchor = anchor;
+        field.dirty = true;
+    }
+
+    void render(sf::RenderTarget& target) {
+        if (!atlasReady)
+            return;
+        for (Field& field : fields) {
+            if (field.dirty) {
+                rebuildField(field);
+            }
+        }
+        sf::RenderStates states;
+        states.texture = &atlasTexture;
+        target.draw(vertices, states);
+        Metrics::count(MetricCounter::DrawCalls);
+    }
+
+private:
+    struct GlyphInfo {
+        float advance = 0.f;
+        sf::FloatRect bounds;
+        sf::IntRect sourceRect;
+        sf::IntRect atlasRect;
+    };
+
+    static constexpr sf::Uint32 firstGlyph = 32;
+    static constexpr sf::Uint32 lastGlyph = 126;
+    static constexpr std::size_t verticesPerGlyph = 6;
+
+    struct GlyphSet {
+        unsigned int characterSize = 0;
+        float lineSpacing = 0.f;
+        std::array<GlyphInfo, lastGlyph - firstGlyph + 1> glyphs;
+    };
+
+    struct Field {
+        sf::Vector2f anchor;
+        unsigned int characterSize = 20;
+        sf::Color color = sf::Color::White;
+        Align align = Align::Left;
+        std::size_t capacity = 0;
+        std::size_t firstVertex = 0;
+        std::string text;
+        bool visible = true;
+        bool dirty = true;
+        bool hasNumber = false;
+        int number = 0;
+    };
+
+    std::vector<Field> fields;
+    std::vector<GlyphSet> glyphSets;
+    sf::VertexArray vertices{ sf::Triangles };
+    sf::Texture atlasTexture;
+    TextureMetric atlasTextureMetric;
+    bool atlasReady = false;
+
+    const GlyphSet* findGlyphSet(unsigned int characterSize) const {
+        for (const GlyphSet& set : glyphSets) {
+            if (set.characterSize == characterSize)
+                return &set;
+        }
+        return nullptr;
+    }
+
+    static const GlyphInfo* lookupGlyph(const GlyphSet& set, char c) {
+        const sf::Uint32 code = static_cast<unsigned char>(c);
+        if (code < firstGlyph || code > lastGlyph)
+            return nullptr;
+        return &set.glyphs[code - firstGlyph];
+    }
+
+    void rebuildField(Field& field) {
+        field.dirty = false;
+        const GlyphSet* set = findGlyphSet(field.characterSize);
+        std::size_t written = 0;
+        if (field.visible && set) {
+            // Measure first so right/center alignment needs no second layout.
+            float lineWidth = 0.f;
+            float maxWidth = 0.f;
+            float top = static_cast<float>(field.characterSize);
+            float bottom = 0.f;
+            int lines = 1;
+            for (char c : field.text) {
+                if (c == '\n') {
+                    maxWidth = std::max(maxWidth, lineWidth);
+                    lineWidth = 0.f;
+                    ++lines;
+                    continue;
+                }
+                if (const GlyphInfo* glyph = lookupGlyph(*set, c)) {
+                    lineWidth += glyph->advance;
+                    if (glyph->bounds.height > 0.f) {
+                        top = std::min(top, static_cast<float>(field.characterSize) + glyph->bounds.top);
+                        bottom = std::max(bottom, static_cast<float>(field.characterSize) + glyph->bounds.top + glyph->bounds.height);
+                    }
+                }
+            }
+            maxWidth = std::max(maxWidth, lineWidth);
+            bottom += static_cast<float>(lines - 1) * set->lineSpacing;
+
+            sf::Vector2f origin = field.anchor;
+            if (field.align == Align::Right) {
+                origin.x -= maxWidth;
+            }
+            else if (field.align == Align::Center) {
+                origin.x -= maxWidth / 2.f;
+                origin.y -= top + (bottom - top) / 2.f;
+            }
+
+            float penX = origin.x;
+            float baseline = origin.y + static_cast<float>(field.characterSize);
+            for (char c : field.text) {
+                if (c == '\n') {
+                    penX = origin.x;
+                    baseline += set->lineSpacing;
+                    continue;
+                }
+                const GlyphInfo* glyph = lookupGlyph(*set, c);
+                if (!glyph)
+                    continue;
+                if (written < field.capacity && glyph->atlasRect.width > 0 && glyph->atlasRect.height > 0) {
+                    writeQuad(field.firstVertex + written * verticesPerGlyph, field.color,
+                        sf::FloatRect(penX + glyph->bounds.left, baseline + glyph->bounds.top,
+                            glyph->bounds.width, glyph->bounds.height),
+                        glyph->atlasRect);
+                    ++written;
+                }
+                penX += glyph->advance;
+            }
+        }
+        // Collapse the unused tail of the slot to degenerate triangles.
+        for (std::size_t i = field.firstVertex + written * verticesPerGlyph;
+            i < field.firstVertex + field.capacity * verticesPerGlyph; ++i) {
+            vertices[i] = sf::Vertex();
+        }
+    }
+
+    void writeQuad(std::size_t first, sf::Color color, const sf::FloatRect& quad, const sf::IntRect& uv) {
+        const float left = quad.left;
+        const float top = quad.top;
+        const float right = quad.left + quad.width;
+        const float bottom = quad.top + quad.height;
+        const float u0 = static_cast<float>(uv.left);
+        const float v0 = static_cast<float>(uv.top);
+        const float u1 = static_cast<float>(uv.left + uv.width);
+        const float v1 = static_cast<float>(uv.top + uv.height);
+        vertices[first + 0] = sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0));
+        vertices[first + 1] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+        vertices[first + 2] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1));
+        vertices[first + 3] = sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1));
+        vertices[first + 4] = sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0));
+        vertices[first + 5] = sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1));
+    }
+};
@@ -1,7 +1,32 @@
 #include "Input.h"
 #include <SFML/Window/Keyboard.hpp>
 
+bool Input::scripted = false;
+std::array<bool, sf::Keyboard::KeyCount> Input::scriptedKeys{};
+
 bool Input::isKeyPressed(sf::Keyboard::Key key) {
+	if (scripted) {
+		return key >= 0 && key < sf::Keyboard::KeyCount && scriptedKeys[key];
+	}
 	return sf::Keyboard::isKeyPressed(key);
 
-}
\ No newline at end of file
+}
+
+void Input::setScripted(bool enabled) {
+	scripted = enabled;
+	releaseAll();
+}
+
+bool Input::isScripted() {
+	return scripted;
+}
+
+void Input::setKey(sf::Keyboard::Key key, bool pressed) {
+	if (key >= 0 && key < sf::Keyboard::KeyCount) {
+		scriptedKeys[key] = pressed;
+	}
+}
+
+void Input::releaseAll() {
+	scriptedKeys.fill(false);
+}
@@ -1,6 +1,17 @@
 #pragma once
 #include <SFML/Window/Keyboard.hpp>
+#include <array>
 
 class Input {
 public: static bool isKeyPressed(sf::Keyboard::Key key);
+	// Scripted runs (benchmarks, soak tests) replace the keyboard with a
+	// virtual key state that the runner sets each frame.
+	static void setScripted(bool scripted);
+	static bool isScripted();
+	static void setKey(sf::Keyboard::Key key, bool pressed);
+	static void releaseAll();
+
+private:
+	static bool scripted;
+	static std::array<bool, sf::Keyboard::KeyCount> scriptedKeys;
 };
@@ -0,0 +1,189 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "CommandLine.h"
+
+// Writes seeded stress levels in the regular level text format: a solid
+// border and floor, rows of floating platforms, and coins, powerups, enemies
+// and moving platforms scattered over free cells. The same Params always
+// produce the same file, on every platform, so scaling runs are repeatable.
+class LevelGenerator {
+public:
+    struct Params {
+        int width = 1000;
+        int height = 20;
+        float platformDensity = 0.3f; // chance per column that a platform starts
+        int coins = 100;
+        int powerups = 10;
+        int enemies = 50;
+        int movingPlatforms = 0;
+        std::uint64_t seed = 1;
+    };
+
+    // Reads --level-* flags into params; anything else is left for the
+    // caller. False, after printing why, when a value is malformed.
+    static bool parseParams(int argc, char** argv, Params& params) {
+        for (int i = 1; i + 1 < argc; ++i) {
+            const char* flag = argv[i];
+            const std::string value = argv[i + 1];
+            bool valid = true;
+            const char* expected = "an integer";
+            if (std::strcmp(flag, "--level-width") == 0) {
+                valid = CommandLine::parseNumber(value, params.width);
+            }
+            else if (std::strcmp(flag, "--level-height") == 0) {
+                valid = CommandLine::parseNumber(value, params.height);
+            }
+            else if (std::strcmp(flag, "--level-platform-density") == 0) {
+                valid = CommandLine::parseNumber(value, params.platformDensity);
+                expected = "a number";
+            }
+            else if (std::strcmp(flag, "--level-coins") == 0) {
+                valid = CommandLine::parseNumber(value, params.coins);
+            }
+            else if (std::strcmp(flag, "--level-powerups") == 0) {
+                valid = CommandLine::parseNumber(value, params.powerups);
+            }
+            else if (std::strcmp(flag, "--level-enemies") == 0) {
+                valid = CommandLine::parseNumber(value, params.enemies);
+            }
+            else if (std::strcmp(flag, "--level-moving-platforms") == 0) {
+                valid = CommandLine::parseNumber(value, params.movingPlatforms);
+            }
+            else if (std::strcmp(flag, "--level-seed") == 0) {
+                valid = CommandLine::parseNumber(value, params.seed);
+                expected = "a non-negative integer";
+            }
+            else {
+                continue;
+            }
+            if (!valid) {
+                return CommandLine::reject("[generate-level]", flag, expected, value.c_str());
+            }
+            ++i;
+        }
+        return true;
+    }
+
+    static std::vector<std::string> generate(Params params) {
+        params.width = std::max(params.width, 8);
+        params.height = std::max(params.height, 6);
+        Random random(params.seed);
+        std::vector<std::string> rows(static_cast<std::size_t>(params.height),
+            std::string(static_cast<std::size_t>(params.width), '0'));
+        const int floorRow = params.height - 1;
+        const int groundRow = params.height - 2; // where things standing on the floor go
+
+        for (int y = 0; y < params.height; ++y) {
+            rows[y][0] = '1';
+            rows[y][params.width - 1] = '1';
+        }
+        std::fill(rows[0].begin(), rows[0].end(), '1');
+        std::fill(rows[floorRow].begin(), rows[floorRow].end(), '1');
+
+        // Platform rows every four tiles up from the floor, leaving
+        // jumping room under each one.
+        for (int y = floorRow - 4; y >= 2; y -= 4) {
+            int x = 2;
+            while (x < params.width - 2) {
+                if (random.chance(params.platformDensity)) {
+                    const int length = random.range(3, 8);
+                    for (int i = 0; i < length && x < params.width - 2; ++i, ++x) {
+                        rows[y][x] = '2';
+                    }
+                    x += 2;
+                }
+                else {
+                    ++x;
+                }
+            }
+        }
+
+        rows[groundRow][1] = 'S';
+        rows[groundRow][params.width - 3] = 'G';
+
+        static const char powerupChars[] = { 'M', 'F', 'L', 'T', 'H', 'R' };
+        place(rows, random, params.enemies, groundRow, groundRow, "enemies", [](Random&) { return 'E'; });
+        place(rows, random, params.coins, 1, groundRow, "coins", [](Random&) { return 'C'; });
+        place(rows, random, params.powerups, 1, groundRow, "powerups",
+            [](Random& r) { return powerupChars[r.range(0, 5)]; });
+        place(rows, random, params.movingPlatforms, 2, groundRow - 1, "moving platforms",
+            [](Random& r) { return r.chance(0.5f) ? 'P' : 'V'; });
+        return rows;
+    }
+
+    static bool writeFile(const Params& params, const std::string& path) {
+        std::ofstream out(path, std::ios::trunc | std::ios::binary);
+        if (!out.is_open()) {
+            std::cerr << "Failed to write generated level: " << path << "\n";
+            return false;
+        }
+        for (const std::string& row : generate(params)) {
+            out << row << '\n';
+        }
+        return static_cast<bool>(out);
+    }
+
+private:
+    // splitmix64; standard distributions differ between library vendors,
+    // which would make the same seed produce different levels.
+    struct Random {
+        std::uint64_t state;
+
+        explicit Random(std::uint64_t seed)
+            : state(seed) {
+        }
+
+        std::uint64_t next() {
+            std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        int range(int low, int high) {
+            return low + static_cast<int>(next() % static_cast<std::uint64_t>(high - low + 1));
+        }
+
+        bool chance(float probability) {
+            return static_cast<float>(next() >> 40) * (1.f / 16777216.f) < probability;
+        }
+    };
+
+    // Puts count markers on free cells in rows [firstRow, lastRow], probing
+    // forward from a random cell when it is already taken.
+    template <typename MakeChar>
+    static void place(std::vector<std::string>& rows, Random& random, int count, int firstRow, int lastRow,
+        const char* what, MakeChar makeChar) {
+        const int width = static_cast<int>(rows.front().size());
+        const long long columns = width - 2;
+        const long long cells = columns * (lastRow - firstRow + 1);
+        int placed = 0;
+        for (int n = 0; n < count && cells > 0; ++n) {
+            long long cell = static_cast<long long>(random.next() % static_cast<std::uint64_t>(cells));
+            bool found = false;
+            for (long long probe = 0; probe < cells; ++probe) {
+                const int y = firstRow + static_cast<int>(cell / columns);
+                const int x = 1 + static_cast<int>(cell % columns);
+                if (rows[y][x] == '0') {
+                    rows[y][x] = makeChar(random);
+                    found = true;
+                    break;
+                }
+                cell = (cell + 1) % cells;
+            }
+            if (!found) {
+                break;
+            }
+            ++placed;
+        }
+        if (placed < count) {
+            std::cerr << "Level generator: only room for " << placed << " of " << count << " " << what << "\n";
+        }
+    }
+};
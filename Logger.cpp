@@ -0,0 +1,249 @@
+#include "Logger.h"
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace {
+    constexpr std::size_t ringCapacity = 1024;
+    static_assert((ringCapacity & (ringCapacity - 1)) == 0, "ringCapacity must be a power of two");
+
+    struct Record {
+        LogLevel level = LogLevel::Info;
+        LogCategory category = LogCategory::General;
+        char text[Log::maxMessageLength + 1] = {};
+    };
+
+    // Bounded multi-producer ring in the style of Vyukov's queue: a slot's
+    // sequence equals its position when free and position + 1 once written,
+    // so producers claim slots with one CAS and never wait on each other or
+    // on the writer. Logs come from the main thread and the asset loader.
+    struct Slot {
+        std::atomic<std::size_t> sequence{ 0 };
+        Record record;
+    };
+
+    class Writer {
+    public:
+        Writer() {
+            for (std::size_t i = 0; i < ringCapacity; ++i) {
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            thread = std::thread([this] { run(); });
+        }
+
+        ~Writer() {
+            stopping.store(true, std::memory_order_release);
+            {
+                std::lock_guard<std::mutex> lock(wakeMutex);
+            }
+            wake.notify_one();
+            thread.join();
+        }
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        // Returns the claimed slot, or nullptr when the ring is full.
+        Slot* claim(std::size_t& position) {
+            position = enqueuePosition.load(std::memory_order_relaxed);
+            for (;;) {
+                Slot& slot = slots[position & (ringCapacity - 1)];
+                const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t difference =
+                    static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                if (difference == 0) {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        return &slot;
+                    }
+                }
+                else if (difference < 0) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                else {
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Takes the wake lock only when the writer has gone to sleep, which
+        // is at most once per burst of records.
+        void publish(Slot& slot, std::size_t position) {
+            slot.sequence.store(position + 1, std::memory_order_seq_cst);
+            if (sleeping.load(std::memory_order_seq_cst)) {
+                {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                }
+                wake.notify_one();
+            }
+        }
+
+        void flush() {
+            const std::size_t target = enqueuePosition.load(std::memory_order_acquire);
+            while (written.load(std::memory_order_acquire) < target) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        std::uint64_t getDropped() const {
+            return dropped.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::array<Slot, ringCapacity> slots;
+        std::atomic<std::size_t> enqueuePosition{ 0 };
+        std::atomic<std::size_t> written{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+        std::atomic<bool> stopping{ false };
+        std::atomic<bool> sleeping{ false };
+        std::mutex wakeMutex;
+        std::condition_variable wake;
+        std::size_t readPosition = 0;
+        std::uint64_t reportedDropped = 0;
+        std::thread thread;
+
+        void run() {
+            for (;;) {
+                // Read before draining so records queued ahead of shutdown still go out.
+                const bool stop = stopping.load(std::memory_order_acquire);
+                if (drain() != 0) {
+                    continue;
+                }
+                if (stop) {
+                    return;
+                }
+                // Block until a record is published or shutdown starts. Both
+                // sides store then load with seq_cst, so either publish() sees
+                // sleeping set and wakes us, or the predicate sees its record.
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                sleeping.store(true, std::memory_order_seq_cst);
+                wake.wait(lock, [this] {
+                    return hasPublished() || stopping.load(std::memory_order_acquire);
+                });
+                sleeping.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        bool hasPublished() const {
+            const Slot& slot = slots[readPosition & (ringCapacity - 1)];
+            return slot.sequence.load(std::memory_order_seq_cst) == readPosition + 1;
+        }
+
+        // Writes every published record in order; streams are flushed once
+        // per batch rather than once per line.
+        std::size_t drain() {
+            std::size_t count = 0;
+            bool wroteOut = false;
+            bool wroteErr = false;
+            for (;;) {
+                Slot& slot = slots[readPosition & (ringCapacity - 1)];
+                if (slot.sequence.load(std::memory_order_acquire) != readPosition + 1) {
+                    break;
+                }
+                const Record& record = slot.record;
+                const bool toErr = record.level >= LogLevel::Warning;
+                std::ostream& stream = toErr ? std::cerr : std::cout;
+                stream << '[' << Log::getName(record.category) << "] ";
+                if (record.level != LogLevel::Info) {
+                    stream << Log::getName(record.level) << ": ";
+                }
+                stream << record.text << '\n';
+                wroteOut = wroteOut || !toErr;
+                wroteErr = wroteErr || toErr;
+
+                slot.sequence.store(readPosition + ringCapacity, std::memory_order_release);
+                ++readPosition;
+                ++count;
+            }
+            const std::uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+            if (droppedNow != reportedDropped) {
+                std::cerr << "[log] ring full, dropped " << droppedNow - reportedDropped << " records\n";
+                reportedDropped = droppedNow;
+                wroteErr = true;
+            }
+            if (wroteOut) {
+                std::cout.flush();
+            }
+            if (wroteErr) {
+                std::cerr.flush();
+            }
+            written.store(readPosition, std::memory_order_release);
+            return count;
+        }
+    };
+
+    // Started on first use and drained on exit.
+    Writer& getWriter() {
+        static Writer writer;
+        return writer;
+    }
+}
+
+void Log::write(LogLevel level, LogCategory category, const char* format, ...) {
+    Writer& writer = getWriter();
+    std::size_t position = 0;
+    Slot* slot = writer.claim(position);
+    if (!slot) {
+        return;
+    }
+    slot->record.level = level;
+    slot->record.category = category;
+    va_list args;
+    va_start(args, format);
+    std::vsnprintf(slot->record.text, sizeof(slot->record.text), format, args);
+    va_end(args);
+    writer.publish(*slot, position);
+}
+
+void Log::flush() {
+    getWriter().flush();
+}
+
+std::uint64_t Log::getDroppedCount() {
+    return getWriter().getDropped();
+}
+
+const char* Log::getName(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug:
+        return "debug";
+    case LogLevel::Info:
+        return "info";
+    case LogLevel::Warning:
+        return "warning";
+    case LogLevel::Error:
+        return "error";
+    default:
+        return "unknown";
+    }
+}
+
+const char* Log::getName(LogCategory category) {
+    switch (category) {
+    case LogCategory::General:
+        return "general";
+    case LogCategory::Gameplay:
+        return "gameplay";
+    case LogCategory::Assets:
+        return "assets";
+    case LogCategory::Input:
+        return "input";
+    default:
+        return "unknown";
+    }
+}
+
+bool Log::parseLevel(const std::string& text, LogLevel& level) {
+    for (LogLevel candidate : { LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error }) {
+        if (text == getName(candidate)) {
+            level = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,82 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Asynchronous logging (Logger.cpp). A call formats into a slot of a fixed
+// lock-free ring buffer and returns; a background thread writes the records
+// out. Nothing is allocated on the calling thread and the only lock taken is
+// a brief one to wake the writer when it is idle; when the ring is full
+// records are dropped and counted rather than waited for, so logging from the
+// game loop never stalls on console I/O.
+enum class LogLevel : std::uint8_t {
+    Debug,
+    Info,
+    Warning,
+    Error
+};
+
+enum class LogCategory : std::uint8_t {
+    General,
+    Gameplay,
+    Assets,
+    Input,
+    Count
+};
+
+namespace Log {
+    // Messages longer than this are truncated.
+    constexpr std::size_t maxMessageLength = 239;
+
+    inline std::atomic<LogLevel> minimumLevel{ LogLevel::Info };
+
+    inline void setLevel(LogLevel level) {
+        minimumLevel.store(level, std::memory_order_relaxed);
+    }
+
+    inline bool isEnabled(LogLevel level) {
+        return level >= minimumLevel.load(std::memory_order_relaxed);
+    }
+
+    // printf-style; pass strings as c_str(). Cheap to call when the level is
+    // filtered out, since formatting happens after the check.
+    void write(LogLevel level, LogCategory category, const char* format, ...);
+
+    template <typename... Args>
+    void debug(LogCategory category, const char* format, Args... args) {
+        if (isEnabled(LogLevel::Debug)) {
+            write(LogLevel::Debug, category, format, args...);
+        }
+    }
+
+    template <typename... Args>
+    void info(LogCategory category, const char* format, Args... args) {
+        if (isEnabled(LogLevel::Info)) {
+            write(LogLevel::Info, category, format, args...);
+        }
+    }
+
+    template <typename... Args>
+    void warning(LogCategory category, const char* format, Args... args) {
+        if (isEnabled(LogLevel::Warning)) {
+            write(LogLevel::Warning, category, format, args...);
+        }
+    }
+
+    template <typename... Args>
+    void error(LogCategory category, const char* format, Args... args) {
+        write(LogLevel::Error, category, format, args...);
+    }
+
+    // Blocks until every record queued so far has been written. For tools
+    // that print reports of their own and want log output out of the way.
+    void flush();
+
+    std::uint64_t getDroppedCount();
+
+    const char* getName(LogLevel level);
+    const char* getName(LogCategory category);
+
+    // Accepts "debug", "info", "warning" or "error"; false leaves level untouched.
+    bool parseLevel(const std::string& text, LogLevel& level);
+}
@@ -1,9 +1,84 @@
 #include "EngineCore.h"
+#include "Benchmarks.h"
+#include "LevelGenerator.h"
+#include "PerfGate.h"
+#include "SoakTest.h"
+#include "CommandLine.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+int main(int argc, char** argv) {
+	for (int i = 1; i + 1 < argc; ++i) {
+		if (std::strcmp(argv[i], "--log-level") == 0) {
+			LogLevel level = LogLevel::Info;
+			if (Log::parseLevel(argv[i + 1], level)) {
+				Log::setLevel(level);
+			}
+		}
+	}
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--bench") == 0) {
+			Benchmarks::Options options;
+			if (!Benchmarks::parseOptions(argc, argv, options)) {
+				return CommandLine::usageError;
+			}
+			return Benchmarks::run(options);
+		}
+		if (std::strcmp(argv[i], "--perf-gate") == 0 || std::strcmp(argv[i], "--perf-gate-update") == 0) {
+			PerfGate::Options options;
+			if (!PerfGate::parseOptions(argc, argv, options)) {
+				return CommandLine::usageError;
+			}
+			return PerfGate::run(options);
+		}
+		if (std::strcmp(argv[i], "--soak") == 0) {
+			SoakTest::Options options;
+			if (!SoakTest::parseOptions(argc, argv, options)) {
+				return CommandLine::usageError;
+			}
+			return SoakTest::run(options);
+		}
+		if (std::strcmp(argv[i], "--generate-level") == 0 && i + 1 < argc) {
+			LevelGenerator::Params params;
+			if (!LevelGenerator::parseParams(argc, argv, params)) {
+				return CommandLine::usageError;
+			}
+			return LevelGenerator::writeFile(params, argv[i + 1]) ? 0 : 1;
+		}
+	}
 
-int main() {
 	EngineCore engine;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--report-allocations") == 0) {
+			engine.reportFrameAllocations = true;
+		}
+		else if (std::strcmp(argv[i], "--track-allocations") == 0) {
+			engine.trackAllocations = true;
+		}
+		else if (std::strcmp(argv[i], "--frame-stats") == 0 && i + 1 < argc) {
+			engine.frameStatsPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--metrics") == 0 && i + 1 < argc) {
+			engine.metricsPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--render-scale") == 0 && i + 1 < argc) {
+			engine.renderScale = std::clamp(std::atoi(argv[++i]), 1, EngineCore::maxRenderScale);
+		}
+		else if (std::strcmp(argv[i], "--dynamic-render-scale") == 0) {
+			engine.dynamicRenderScale = true;
+			// The target frame time in milliseconds is optional.
+			if (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) {
+				const double targetMilliseconds = std::atof(argv[++i]);
+				if (targetMilliseconds > 0.0) {
+					engine.targetFrameTime = static_cast<float>(targetMilliseconds / 1000.0);
+				}
+			}
+		}
+	}
 
 	engine.run();
 	return 0;
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,83 @@
+#include "Metrics.h"
+#include "Logger.h"
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+const char* Metrics::getName(MetricCounter counter) {
+    switch (counter) {
+    case MetricCounter::DrawCalls:
+        return "draw_calls";
+    case MetricCounter::TilesDrawn:
+        return "tiles_drawn";
+    case MetricCounter::CollisionQueries:
+        return "collision_queries";
+    default:
+        return "unknown";
+    }
+}
+
+const char* Metrics::getName(MetricGauge gauge) {
+    switch (gauge) {
+    case MetricGauge::LiveEntities:
+        return "live_entities";
+    case MetricGauge::Enemies:
+        return "enemies";
+    case MetricGauge::Projectiles:
+        return "projectiles";
+    case MetricGauge::Textures:
+        return "textures";
+    case MetricGauge::TextureBytes:
+        return "texture_bytes";
+    default:
+        return "unknown";
+    }
+}
+
+bool Metrics::writeJson(const std::string& path, double uptimeSeconds) {
+    if constexpr (!enabled) {
+        return false;
+    }
+    const std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream out(temporaryPath, std::ios::trunc);
+        if (!out.is_open()) {
+            Log::error(LogCategory::General, "Failed to write metrics: %s", temporaryPath.c_str());
+            return false;
+        }
+        const double ticks = static_cast<double>(registry.windowTicks);
+        out << "{\n  \"uptime_seconds\": " << uptimeSeconds
+            << ",\n  \"ticks\": " << registry.totalTicks
+            << ",\n  \"window_ticks\": " << registry.windowTicks
+            << ",\n  \"counters\": {";
+        for (std::size_t i = 0; i < counterCount; ++i) {
+            out << (i == 0 ? "\n" : ",\n") << "    \"" << getName(static_cast<MetricCounter>(i))
+                << "\": {\"last_tick\": " << registry.lastTick[i]
+                << ", \"per_tick\": " << (ticks > 0.0 ? static_cast<double>(registry.window[i]) / ticks : 0.0)
+                << ", \"total\": " << registry.total[i] << '}';
+        }
+        out << "\n  },\n  \"gauges\": {";
+        for (std::size_t i = 0; i < gaugeCount; ++i) {
+            out << (i == 0 ? "\n" : ",\n") << "    \"" << getName(static_cast<MetricGauge>(i))
+                << "\": " << registry.gauges[i];
+        }
+        out << "\n  }\n}\n";
+        if (!out) {
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        // Windows refuses to rename over a file another process has open.
+        std::filesystem::copy_file(temporaryPath, path, std::filesystem::copy_options::overwrite_existing, error);
+        std::filesystem::remove(temporaryPath);
+        if (error) {
+            Log::error(LogCategory::General, "Failed to write metrics: %s", path.c_str());
+            return false;
+        }
+    }
+    registry.window.fill(0);
+    registry.windowTicks = 0;
+    return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// Build with ENGINE_METRICS=0 to compile every counter and gauge update below
+// to nothing; the registry, the texture gauges and the JSON flush go with it.
+#ifndef ENGINE_METRICS
+#define ENGINE_METRICS 1
+#endif
+
+// Counters accumulate over one tick (a frame) and are rolled over by
+// Metrics::endTick(); gauges hold a current value until changed.
+enum class MetricCounter : std::uint8_t {
+    DrawCalls,
+    TilesDrawn,
+    CollisionQueries,
+    Count
+};
+
+enum class MetricGauge : std::uint8_t {
+    LiveEntities,
+    Enemies,
+    Projectiles,
+    Textures,
+    TextureBytes,
+    Count
+};
+
+// Main-thread only: updates are plain increments with no synchronisation.
+namespace Metrics {
+    constexpr bool enabled = ENGINE_METRICS != 0;
+    constexpr std::size_t counterCount = static_cast<std::size_t>(MetricCounter::Count);
+    constexpr std::size_t gaugeCount = static_cast<std::size_t>(MetricGauge::Count);
+
+    struct Registry {
+        std::array<std::uint64_t, counterCount> current{};  // this tick so far
+        std::array<std::uint64_t, counterCount> lastTick{};
+        std::array<std::uint64_t, counterCount> window{};   // since the last flush
+        std::array<std::uint64_t, counterCount> total{};
+        std::array<std::int64_t, gaugeCount> gauges{};
+        std::uint64_t windowTicks = 0;
+        std::uint64_t totalTicks = 0;
+    };
+
+    inline Registry registry;
+
+    inline void count(MetricCounter counter, std::uint64_t amount = 1) {
+        if constexpr (enabled) {
+            registry.current[static_cast<std::size_t>(counter)] += amount;
+        }
+    }
+
+    inline void set(MetricGauge gauge, std::int64_t value) {
+        if constexpr (enabled) {
+            registry.gauges[static_cast<std::size_t>(gauge)] = value;
+        }
+    }
+
+    inline void add(MetricGauge gauge, std::int64_t delta) {
+        if constexpr (enabled) {
+            registry.gauges[static_cast<std::size_t>(gauge)] += delta;
+        }
+    }
+
+    inline std::uint64_t getLastTick(MetricCounter counter) {
+        return registry.lastTick[static_cast<std::size_t>(counter)];
+    }
+
+    inline std::int64_t get(MetricGauge gauge) {
+        return registry.gauges[static_cast<std::size_t>(gauge)];
+    }
+
+    inline void endTick() {
+        if constexpr (enabled) {
+            for (std::size_t i = 0; i < counterCount; ++i) {
+                registry.lastTick[i] = registry.current[i];
+                registry.window[i] += registry.current[i];
+                registry.total[i] += registry.current[i];
+                registry.current[i] = 0;
+            }
+            ++registry.windowTicks;
+            ++registry.totalTicks;
+        }
+    }
+
+    const char* getName(MetricCounter counter);
+    const char* getName(MetricGauge gauge);
+
+    // Writes a snapshot to path (through a temporary file, so readers never
+    // see half a document) and starts a new per-tick averaging window.
+    bool writeJson(const std::string& path, double uptimeSeconds);
+}
+
+// Counts a texture in the Textures and TextureBytes gauges for as long as
+// the owner keeps it; put one next to each sf::Texture and call set() after
+// every (re)load.
+class TextureMetric {
+public:
+    TextureMetric() = default;
+
+    TextureMetric(const TextureMetric& other) {
+        assign(other.textures, other.bytes);
+    }
+
+    TextureMetric& operator=(const TextureMetric& other) {
+        assign(other.textures, other.bytes);
+        return *this;
+    }
+
+    ~TextureMetric() {
+        assign(0, 0);
+    }
+
+    void set(const sf::Texture& texture) {
+        const sf::Vector2u size = texture.getSize();
+        const std::int64_t textureBytes = static_cast<std::int64_t>(size.x) * size.y * 4;
+        assign(textureBytes > 0 ? 1 : 0, textureBytes);
+    }
+
+    // For owners of several textures, e.g. atlas pages.
+    void assign(std::int64_t textureCount, std::int64_t textureBytes) {
+        if constexpr (Metrics::enabled) {
+            Metrics::add(MetricGauge::Textures, textureCount - textures);
+            Metrics::add(MetricGauge::TextureBytes, textureBytes - bytes);
+            textures = textureCount;
+            bytes = textureBytes;
+        }
+    }
+
+private:
+    std::int64_t textures = 0;
+    std::int64_t bytes = 0;
+};
@@ -2,9 +2,11 @@
 #include "Component.h"
 #include "TransformComponent.h"
 #include "Tilemap.h"
+#include "TileCollision.h"
 #include "SpriteComponent.h"
 #include "AnimationComponent.h"
 #include "PhysicsComponent.h"
+#include "Input.h"
 #include <SFML/Window/Keyboard.hpp>
 #include <algorithm>
 #include <cmath>
@@ -56,23 +58,24 @@ public:
         SpriteComponent* sprite = entity->getComponent<SpriteComponent>();
         PhysicsComponent* physics = entity->getComponent<PhysicsComponent>();
         const bool grounded = physics ? physics->onGround : true;
+        const float friction = (physics && grounded) ? physics->groundFriction : 1.f;
 
         // Input
         const bool moveLeft =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::A) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::Left);
+            Input::isKeyPressed(sf::Keyboard::A) ||
+            Input::isKeyPressed(sf::Keyboard::Left);
 
         const bool moveRight =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::D) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::Right);
+            Input::isKeyPressed(sf::Keyboard::D) ||
+            Input::isKeyPressed(sf::Keyboard::Right);
 
         const bool crouchPressed =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::S) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::Down);
+            Input::isKeyPressed(sf::Keyboard::S) ||
+            Input::isKeyPressed(sf::Keyboard::Down);
 
         const bool running =
-            sf::Keyboard::isKeyPressed(sf::Keyboard::LShift) ||
-            sf::Keyboard::isKeyPressed(sf::Keyboard::RShift);
+            Input::isKeyPressed(sf::Keyboard::LShift) ||
+            Input::isKeyPressed(sf::Keyboard::RShift);
 
         if (grounded && crouchPressed) {
             setCrouching(true);
@@ -105,7 +108,7 @@ public:
         if (targetVelocity != 0.f) {
             targetVelocity = std::clamp(targetVelocity, -effectiveMaxSpeed, effectiveMaxSpeed);
             const float delta = targetVelocity - velocityX;
-            const float accelRate = grounded ? acceleration : airAcceleration;
+            const float accelRate = grounded ? acceleration * friction : airAcceleration;
             const float accel = accelRate * dt;
 
             if (std::abs(delta) <= accel) {
@@ -116,7 +119,7 @@ public:
             }
         }
         else {
-            const float decelRate = grounded ? deacceleration : airDeacceleration;
+            const float decelRate = grounded ? deacceleration * friction : airDeacceleration;
             const float decel = decelRate * dt;
             if (std::abs(velocityX) <= decel) {
                 velocityX = 0.f;
@@ -126,7 +129,7 @@ public:
             }
         }
         if (grounded && targetVelocity != 0.f && (targetVelocity * velocityX) < 0.f) {
-            const float skid = skidDeceleration * dt;
+            const float skid = skidDeceleration * friction * dt;
             if (std::abs(velocityX) <= skid) {
                 velocityX = 0.f;
 
@@ -154,54 +157,11 @@ public:
         if (velocityX == 0.f)
             return;
 
-        // Proposed new X position
-        float newX = transform->position.x + velocityX * dt;
-
-        // Collision check at feet level
-        const float topY = transform->position.y + 1.f;
-        const float bottomY = transform->position.y + colliderHeight - 1.f;
-        const int tileYTop = static_cast<int>(topY) / tilemap->tileSize;
-        const int tileYBottom = static_cast<int>(bottomY) / tilemap->tileSize;
-
-
-
-        int tileXLeft =
-            static_cast<int>(newX) / tilemap->tileSize;
-
-        int tileXRight =
-            static_cast<int>(newX + colliderWidth - 1.f) / tilemap->tileSize;
-        auto isBlocked = [&](int tileX) {
-            for (int tileY = tileYTop; tileY <= tileYBottom; ++tileY) {
-                if (tilemap->isSolid(tileX, tileY)) {
-                    return true;
-                }
-            }
-            return false;
-            };
-
-   
-
-        // Moving left
-        if (velocityX < 0.f) {
-            if (isBlocked(tileXLeft)) {
-                transform->position.x =
-                    (tileXLeft + 1) * tilemap->tileSize;
-                velocityX = 0.f;
-            }
-            else {
-                transform->position.x = newX;
-            }
-        }
-        // Moving right
-        else if (velocityX > 0.f) {
-            if (isBlocked(tileXRight)) {
-                transform->position.x =
-                    tileXRight * tilemap->tileSize - colliderWidth;
-                velocityX = 0.f;
-            }
-            else {
-                transform->position.x = newX;
-            }
+        const TileCollision::Result contact = TileCollision::sweep(*tilemap, transform->position,
+            { colliderWidth, colliderHeight }, { velocityX * dt, 0.f });
+        transform->position = contact.position;
+        if (contact.hitX()) {
+            velocityX = 0.f;
         }
     }
     void setBaseScaleY(float newBaseScaleY) {
@@ -265,21 +225,7 @@ private:
         if (delta <= 0.f) {
             return true;
         }
-        const float newTopY = transform->position.y - delta;
-        const float leftX = transform->position.x;
-        const float rightX = transform->position.x + colliderWidth - 1.f;
-        const int tileXLeft = static_cast<int>(leftX) / tilemap->tileSize;
-        const int tileXRight = static_cast<int>(rightX) / tilemap->tileSize;
-        const int tileYTop = static_cast<int>(newTopY) / tilemap->tileSize;
-        const int tileYBottom = static_cast<int>(newTopY + desiredHeight - 1.f) / tilemap->tileSize;
-
-        for (int x = tileXLeft; x <= tileXRight; ++x) {
-            for (int y = tileYTop; y <= tileYBottom; ++y) {
-                if (tilemap->isSolid(x, y)) {
-                    return false;
-                }
-            }
-        }
-        return true;
+        const sf::Vector2f standingPosition(transform->position.x, transform->position.y - delta);
+        return !TileCollision::overlapsSolid(*tilemap, standingPosition, { colliderWidth, desiredHeight });
     }
 };
@@ -0,0 +1,188 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+
+// Kinematic one-way platforms that ping-pong along a straight path. They move
+// in Tilemap::update, before any entity updates, so riders are carried by the
+// same tick's motion. A coarse bucket grid, refilled every tick, keeps
+// collision lookups limited to nearby platforms.
+class MovingPlatforms {
+public:
+    struct Spawn {
+        sf::Vector2f position; // top-left at the start of the path
+        sf::Vector2f travel;   // offset to the far end of the path
+    };
+
+    struct Platform {
+        sf::Vector2f origin;
+        sf::Vector2f size;
+        sf::Vector2f travel;
+        float speed = 60.f; // pixels per second along the path
+        float elapsed = 0.f;
+        sf::Vector2f position;
+        sf::Vector2f delta; // movement applied by the last update
+    };
+
+    static constexpr float bucketSize = 256.f;
+
+    void clear() {
+        platforms.clear();
+        buckets.clear();
+        bucketColumns = 0;
+        bucketRows = 0;
+    }
+
+    void load(const std::vector<Spawn>& spawns, sf::Vector2f size, float speed) {
+        clear();
+        if (spawns.empty()) {
+            return;
+        }
+        platforms.reserve(spawns.size());
+        for (const Spawn& spawn : spawns) {
+            Platform platform;
+            platform.origin = spawn.position;
+            platform.size = size;
+            platform.travel = spawn.travel;
+            platform.speed = speed;
+            platform.position = spawn.position;
+            platforms.push_back(platform);
+        }
+        sizeGrid();
+        rebuildBuckets();
+    }
+
+    void reset() {
+        for (Platform& platform : platforms) {
+            platform.elapsed = 0.f;
+            platform.position = platform.origin;
+            platform.delta = sf::Vector2f(0.f, 0.f);
+        }
+        rebuildBuckets();
+    }
+
+    void update(float dt) {
+        for (Platform& platform : platforms) {
+            const float length = std::sqrt(platform.travel.x * platform.travel.x + platform.travel.y * platform.travel.y);
+            if (length <= 0.f || platform.speed <= 0.f) {
+                platform.delta = sf::Vector2f(0.f, 0.f);
+                continue;
+            }
+            platform.elapsed += dt;
+            const float along = std::fmod(platform.elapsed * platform.speed, 2.f * length);
+            const float t = (along <= length ? along : 2.f * length - along) / length;
+            const sf::Vector2f next = platform.origin + platform.travel * t;
+            platform.delta = next - platform.position;
+            platform.position = next;
+        }
+        rebuildBuckets();
+    }
+
+    bool empty() const {
+        return platforms.empty();
+    }
+
+    std::size_t size() const {
+        return platforms.size();
+    }
+
+    const Platform& get(std::size_t index) const {
+        return platforms[index];
+    }
+
+    sf::Vector2f getDelta(int index) const {
+        if (index < 0 || index >= static_cast<int>(platforms.size())) {
+            return sf::Vector2f(0.f, 0.f);
+        }
+        return platforms[index].delta;
+    }
+
+    // Calls fn(index, platform) once for every platform whose bucket touches area.
+    template <typename Fn>
+    void forEachNear(const sf::FloatRect& area, Fn&& fn) const {
+        if (platforms.empty()) {
+            return;
+        }
+        ++visitStamp;
+        const int firstX = std::max(0, bucketIndex(area.left - gridOrigin.x));
+        const int lastX = std::min(bucketColumns - 1, bucketIndex(area.left + area.width - gridOrigin.x));
+        const int firstY = std::max(0, bucketIndex(area.top - gridOrigin.y));
+        const int lastY = std::min(bucketRows - 1, bucketIndex(area.top + area.height - gridOrigin.y));
+        for (int y = firstY; y <= lastY; ++y) {
+            for (int x = firstX; x <= lastX; ++x) {
+                for (int index : buckets[static_cast<std::size_t>(y * bucketColumns + x)]) {
+                    if (visited[index] == visitStamp) {
+                        continue;
+                    }
+                    visited[index] = visitStamp;
+                    fn(index, platforms[index]);
+                }
+            }
+        }
+    }
+
+    // True if a platform top lies within depth pixels below point.
+    bool hasPlatformBelow(sf::Vector2f point, float depth) const {
+        bool found = false;
+        forEachNear(sf::FloatRect(point.x, point.y, 0.f, depth), [&](int, const Platform& platform) {
+            if (point.x >= platform.position.x && point.x < platform.position.x + platform.size.x
+                && platform.position.y >= point.y && platform.position.y <= point.y + depth) {
+                found = true;
+            }
+        });
+        return found;
+    }
+
+private:
+    std::vector<Platform> platforms;
+    std::vector<std::vector<int>> buckets;
+    mutable std::vector<std::uint32_t> visited;
+    mutable std::uint32_t visitStamp = 0;
+    sf::Vector2f gridOrigin;
+    int bucketColumns = 0;
+    int bucketRows = 0;
+
+    static int bucketIndex(float coordinate) {
+        return static_cast<int>(std::floor(coordinate / bucketSize));
+    }
+
+    // Platforms never leave their paths, so a grid covering every path is
+    // sized once per level.
+    void sizeGrid() {
+        sf::Vector2f minCorner = platforms.front().origin;
+        sf::Vector2f maxCorner = minCorner;
+        for (const Platform& platform : platforms) {
+            const sf::Vector2f end = platform.origin + platform.travel;
+            minCorner.x = std::min({ minCorner.x, platform.origin.x, end.x });
+            minCorner.y = std::min({ minCorner.y, platform.origin.y, end.y });
+            maxCorner.x = std::max({ maxCorner.x, platform.origin.x + platform.size.x, end.x + platform.size.x });
+            maxCorner.y = std::max({ maxCorner.y, platform.origin.y + platform.size.y, end.y + platform.size.y });
+        }
+        gridOrigin = minCorner;
+        bucketColumns = bucketIndex(maxCorner.x - minCorner.x) + 1;
+        bucketRows = bucketIndex(maxCorner.y - minCorner.y) + 1;
+        buckets.assign(static_cast<std::size_t>(bucketColumns * bucketRows), {});
+        visited.assign(platforms.size(), 0);
+        visitStamp = 0;
+    }
+
+    void rebuildBuckets() {
+        for (auto& bucket : buckets) {
+            bucket.clear();
+        }
+        for (std::size_t i = 0; i < platforms.size(); ++i) {
+            const Platform& platform = platforms[i];
+            const int firstX = std::max(0, bucketIndex(platform.position.x - gridOrigin.x));
+            const int lastX = std::min(bucketColumns - 1, bucketIndex(platform.position.x + platform.size.x - gridOrigin.x));
+            const int firstY = std::max(0, bucketIndex(platform.position.y - gridOrigin.y));
+            const int lastY = std::min(bucketRows - 1, bucketIndex(platform.position.y + platform.size.y - gridOrigin.y));
+            for (int y = firstY; y <= lastY; ++y) {
+                for (int x = firstX; x <= lastX; ++x) {
+                    buckets[static_cast<std::size_t>(y * bucketColumns + x)].push_back(static_cast<int>(i));
+                }
+            }
+        }
+    }
+};
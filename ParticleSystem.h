@@ -0,0 +1,163 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include "Metrics.h"
+
+// Short-lived visual effects kept out of Scene. Particles are stored as
+// parallel arrays in a fixed-capacity pool so the integration loop is plain
+// float arithmetic the compiler can vectorize, and the whole pool is drawn
+// with one vertex array.
+class ParticleSystem {
+public:
+    struct Burst {
+        int count = 12;
+        sf::Color color = sf::Color::White;
+        float speedMin = 60.f;
+        float speedMax = 180.f;
+        float lifeMin = 0.25f;
+        float lifeMax = 0.6f;
+        float size = 4.f;
+        float gravity = 600.f;
+        float upwardBias = 0.f; // added to every particle's initial upward speed
+    };
+
+    static Burst makeBurst(int count, sf::Color color, float size, float upwardBias = 0.f) {
+        Burst burst;
+        burst.count = count;
+        burst.color = color;
+        burst.size = size;
+        burst.upwardBias = upwardBias;
+        return burst;
+    }
+
+    explicit ParticleSystem(std::size_t capacity = 32768)
+        : capacity(capacity) {
+        posX.resize(capacity);
+        posY.resize(capacity);
+        velX.resize(capacity);
+        velY.resize(capacity);
+        gravity.resize(capacity);
+        life.resize(capacity);
+        inverseMaxLife.resize(capacity);
+        halfSize.resize(capacity);
+        color.resize(capacity);
+        vertices.resize(capacity * 6);
+    }
+
+    // Emits up to burst.count particles; when the pool is full the rest are dropped.
+    void emit(sf::Vector2f position, const Burst& burst) {
+        const std::size_t available = capacity - alive;
+        const std::size_t count = std::min(available, static_cast<std::size_t>(std::max(0, burst.count)));
+        for (std::size_t n = 0; n < count; ++n) {
+            const std::size_t i = alive++;
+            const float angle = random01() * 6.2831853f;
+            const float speed = burst.speedMin + (burst.speedMax - burst.speedMin) * random01();
+            const float lifetime = std::max(0.01f, burst.lifeMin + (burst.lifeMax - burst.lifeMin) * random01());
+            posX[i] = position.x;
+            posY[i] = position.y;
+            velX[i] = std::cos(angle) * speed;
+            velY[i] = std::sin(angle) * speed - burst.upwardBias;
+            gravity[i] = burst.gravity;
+            life[i] = lifetime;
+            inverseMaxLife[i] = 1.f / lifetime;
+            halfSize[i] = burst.size / 2.f;
+            color[i] = burst.color;
+        }
+    }
+
+    void update(float dt) {
+        const std::size_t count = alive;
+        float* px = posX.data();
+        float* py = posY.data();
+        float* vx = velX.data();
+        float* vy = velY.data();
+        const float* g = gravity.data();
+        float* l = life.data();
+        // Branch-free so it vectorizes; dead particles are compacted after.
+        for (std::size_t i = 0; i < count; ++i) {
+            vy[i] += g[i] * dt;
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            l[i] -= dt;
+        }
+        // Swap-remove keeps the live range dense without shifting arrays.
+        std::size_t i = 0;
+        while (i < alive) {
+            if (life[i] > 0.f) {
+                ++i;
+                continue;
+            }
+            const std::size_t last = --alive;
+            posX[i] = posX[last];
+            posY[i] = posY[last];
+            velX[i] = velX[last];
+            velY[i] = velY[last];
+            gravity[i] = gravity[last];
+            life[i] = life[last];
+            inverseMaxLife[i] = inverseMaxLife[last];
+            halfSize[i] = halfSize[last];
+            color[i] = color[last];
+        }
+    }
+
+    void render(sf::RenderTarget& target) {
+        if (alive == 0) {
+            return;
+        }
+        for (std::size_t i = 0; i < alive; ++i) {
+            sf::Color c = color[i];
+            c.a = static_cast<sf::Uint8>(c.a * std::clamp(life[i] * inverseMaxLife[i], 0.f, 1.f));
+            const float left = posX[i] - halfSize[i];
+            const float right = posX[i] + halfSize[i];
+            const float top = posY[i] - halfSize[i];
+            const float bottom = posY[i] + halfSize[i];
+            sf::Vertex* quad = &vertices[i * 6];
+            quad[0] = sf::Vertex(sf::Vector2f(left, top), c);
+            quad[1] = sf::Vertex(sf::Vector2f(right, top), c);
+            quad[2] = sf::Vertex(sf::Vector2f(left, bottom), c);
+            quad[3] = sf::Vertex(sf::Vector2f(left, bottom), c);
+            quad[4] = sf::Vertex(sf::Vector2f(right, top), c);
+            quad[5] = sf::Vertex(sf::Vector2f(right, bottom), c);
+        }
+        target.draw(vertices.data(), alive * 6, sf::Triangles);
+        Metrics::count(MetricCounter::DrawCalls);
+    }
+
+    void clear() {
+        alive = 0;
+    }
+
+    std::size_t getAliveCount() const {
+        return alive;
+    }
+
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+private:
+    std::size_t capacity;
+    std::size_t alive = 0;
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velX;
+    std::vector<float> velY;
+    std::vector<float> gravity;
+    std::vector<float> life;
+    std::vector<float> inverseMaxLife;
+    std::vector<float> halfSize;
+    std::vector<sf::Color> color;
+    std::vector<sf::Vertex> vertices;
+    std::uint32_t randomState = 0x9E3779B9u;
+
+    // xorshift32: cheap and good enough for visual jitter.
+    float random01() {
+        randomState ^= randomState << 13;
+        randomState ^= randomState >> 17;
+        randomState ^= randomState << 5;
+        return static_cast<float>(randomState >> 8) * (1.f / 16777216.f);
+    }
+};
@@ -0,0 +1,359 @@
+#include "PerfGate.h"
+#include "EngineCore.h"
+#include "CommandLine.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    using MetricValues = std::map<std::string, double>;
+
+    struct Tolerance {
+        double relative = 0.0;
+        double absolute = 0.0;
+    };
+
+    // Keyed by the last component of a metric name. The absolute slack keeps
+    // sub-millisecond timings from failing on scheduler noise.
+    std::map<std::string, Tolerance> defaultTolerances() {
+        return {
+            { "frame_p50_ms", { 0.15, 0.05 } },
+            { "frame_p95_ms", { 0.25, 0.10 } },
+            { "allocations_per_frame", { 0.10, 1.0 } },
+            { "load_ms", { 0.25, 0.5 } },
+            { "ns_per_op", { 0.20, 0.0 } },
+        };
+    }
+
+    std::string metricKind(const std::string& name) {
+        const std::size_t dot = name.rfind('.');
+        return dot == std::string::npos ? name : name.substr(dot + 1);
+    }
+
+    // Just enough JSON for the baseline file: nested objects are flattened
+    // into dotted keys holding their numbers; strings, arrays and literals
+    // are skipped.
+    class JsonReader {
+    public:
+        explicit JsonReader(const std::string& text)
+            : text(text) {
+        }
+
+        MetricValues parse() {
+            MetricValues values;
+            skipSpace();
+            parseValue("", values);
+            skipSpace();
+            if (pos != text.size()) {
+                fail("trailing characters");
+            }
+            return values;
+        }
+
+    private:
+        const std::string& text;
+        std::size_t pos = 0;
+
+        [[noreturn]] void fail(const char* what) const {
+            throw std::runtime_error(std::string("baseline JSON: ") + what + " at offset " + std::to_string(pos));
+        }
+
+        void skipSpace() {
+            while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos]))) {
+                ++pos;
+            }
+        }
+
+        void expect(char c) {
+            skipSpace();
+            if (pos >= text.size() || text[pos] != c) {
+                fail("unexpected character");
+            }
+            ++pos;
+        }
+
+        std::string parseString() {
+            expect('"');
+            std::string value;
+            while (pos < text.size() && text[pos] != '"') {
+                if (text[pos] == '\\' && pos + 1 < text.size()) {
+                    ++pos;
+                }
+                value += text[pos++];
+            }
+            expect('"');
+            return value;
+        }
+
+        void parseValue(const std::string& key, MetricValues& values) {
+            skipSpace();
+            if (pos >= text.size()) {
+                fail("unexpected end");
+            }
+            const char c = text[pos];
+            if (c == '{') {
+                ++pos;
+                skipSpace();
+                if (pos < text.size() && text[pos] == '}') {
+                    ++pos;
+                    return;
+                }
+                for (;;) {
+                    const std::string name = parseString();
+                    expect(':');
+                    parseValue(key.empty() ? name : key + "." + name, values);
+                    skipSpace();
+                    if (pos < text.size() && text[pos] == ',') {
+                        ++pos;
+                        continue;
+                    }
+                    expect('}');
+                    return;
+                }
+            }
+            if (c == '[') {
+                ++pos;
+                skipSpace();
+                if (pos < text.size() && text[pos] == ']') {
+                    ++pos;
+                    return;
+                }
+                for (;;) {
+                    parseValue(key + "[]", values);
+                    skipSpace();
+                    if (pos < text.size() && text[pos] == ',') {
+                        ++pos;
+                        continue;
+                    }
+                    expect(']');
+                    return;
+                }
+            }
+            if (c == '"') {
+                parseString();
+                return;
+            }
+            if (c == '-' || std::isdigit(static_cast<unsigned char>(c))) {
+                std::size_t used = 0;
+                const double number = std::stod(text.substr(pos, 32), &used);
+                pos += used;
+                if (!key.empty()) {
+                    values[key] = number;
+                }
+                return;
+            }
+            for (const char* literal : { "true", "false", "null" }) {
+                const std::size_t length = std::strlen(literal);
+                if (text.compare(pos, length, literal) == 0) {
+                    pos += length;
+                    return;
+                }
+            }
+            fail("unexpected character");
+        }
+    };
+
+    MetricValues measureLevels(const PerfGate::Options& options) {
+        MetricValues metrics;
+        EngineCore engine(true);
+        for (int level = 0; level < engine.getLevelCount(); ++level) {
+            const EngineCore::HeadlessLevelStats stats =
+                engine.runHeadlessLevel(level, options.framesPerLevel, options.dt);
+            const std::string prefix = "level." + std::filesystem::path(stats.file).stem().string() + ".";
+            metrics[prefix + "frame_p50_ms"] = EngineCore::HeadlessLevelStats::percentile(stats.frameMilliseconds, 0.50);
+            metrics[prefix + "frame_p95_ms"] = EngineCore::HeadlessLevelStats::percentile(stats.frameMilliseconds, 0.95);
+            if (AllocationTracker::compiledIn) {
+                metrics[prefix + "allocations_per_frame"] = stats.allocationsPerFrame;
+            }
+            metrics[prefix + "load_ms"] = stats.loadMilliseconds;
+            std::cerr << "[perf-gate] " << stats.file << ": " << stats.frameMilliseconds.size()
+                << " frames, " << stats.restarts << " restarts\n";
+        }
+        return metrics;
+    }
+
+    MetricValues measureBenchmarks(const PerfGate::Options& options) {
+        MetricValues metrics;
+        for (const Benchmarks::Result& result : Benchmarks::collect(options.bench)) {
+            std::string name = "bench." + result.name + "(";
+            for (std::size_t p = 0; p < result.params.size(); ++p) {
+                name += (p == 0 ? "" : ",") + result.params[p].first + "=" + std::to_string(result.params[p].second);
+            }
+            metrics[name + ").ns_per_op"] = result.nanosecondsPerOperation();
+        }
+        return metrics;
+    }
+
+    bool writeBaseline(const PerfGate::Options& options, const MetricValues& metrics) {
+        std::ofstream out(options.baselinePath, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[perf-gate] could not write " << options.baselinePath << "\n";
+            return false;
+        }
+        out << "{\n  \"suite\": \"perf-gate\",\n  \"frames_per_level\": " << options.framesPerLevel
+            << ",\n  \"tolerances\": {";
+        bool first = true;
+        for (const auto& [kind, tolerance] : defaultTolerances()) {
+            out << (first ? "\n" : ",\n") << "    \"" << kind << "\": {\"relative\": " << tolerance.relative
+                << ", \"absolute\": " << tolerance.absolute << '}';
+            first = false;
+        }
+        out << "\n  },\n  \"metrics\": {";
+        first = true;
+        out << std::setprecision(9);
+        for (const auto& [name, value] : metrics) {
+            out << (first ? "\n" : ",\n") << "    \"" << name << "\": " << value;
+            first = false;
+        }
+        out << "\n  }\n}\n";
+        std::cout << "[perf-gate] wrote " << metrics.size() << " metrics to " << options.baselinePath << "\n";
+        return static_cast<bool>(out);
+    }
+
+    // Prints one row per baseline metric and returns the number of regressions.
+    // Benchmark rows only count as missing when the whole suite ran, and
+    // allocation rows only in builds that count allocations.
+    int compare(const MetricValues& baseline, const MetricValues& current, bool fullBenchSuite) {
+        std::map<std::string, Tolerance> tolerances = defaultTolerances();
+        for (auto& [kind, tolerance] : tolerances) {
+            const std::string prefix = "tolerances." + kind + ".";
+            if (auto it = baseline.find(prefix + "relative"); it != baseline.end()) {
+                tolerance.relative = it->second;
+            }
+            if (auto it = baseline.find(prefix + "absolute"); it != baseline.end()) {
+                tolerance.absolute = it->second;
+            }
+        }
+
+        const std::string metricsPrefix = "metrics.";
+        int regressions = 0;
+        int compared = 0;
+        std::cout << std::left << std::setw(72) << "metric" << std::right
+            << std::setw(14) << "baseline" << std::setw(14) << "current" << std::setw(10) << "change" << "  status\n";
+        std::cout << std::fixed << std::setprecision(4);
+        for (const auto& [key, expected] : baseline) {
+            if (key.compare(0, metricsPrefix.size(), metricsPrefix) != 0) {
+                continue;
+            }
+            const std::string name = key.substr(metricsPrefix.size());
+            std::cout << std::left << std::setw(72) << name << std::right << std::setw(14) << expected;
+            const auto found = current.find(name);
+            const bool notMeasured = (!fullBenchSuite && name.compare(0, 6, "bench.") == 0)
+                || (!AllocationTracker::compiledIn && metricKind(name) == "allocations_per_frame");
+            if (found == current.end() && notMeasured) {
+                std::cout << std::setw(14) << "-" << std::setw(10) << "-" << "  skipped\n";
+                continue;
+            }
+            if (found == current.end()) {
+                // A case that silently stopped running must not pass the gate.
+                std::cout << std::setw(14) << "-" << std::setw(10) << "-" << "  MISSING\n";
+                ++regressions;
+                continue;
+            }
+            ++compared;
+            const double actual = found->second;
+            const auto tolerance = tolerances.find(metricKind(name));
+            const Tolerance allowed = tolerance != tolerances.end() ? tolerance->second : Tolerance{ 0.20, 0.0 };
+            const double limit = expected * (1.0 + allowed.relative) + allowed.absolute;
+            const double change = expected != 0.0 ? (actual - expected) / expected * 100.0 : 0.0;
+            const char* status = "ok";
+            if (actual > limit) {
+                status = "REGRESSED";
+                ++regressions;
+            }
+            else if (actual < expected * (1.0 - allowed.relative) - allowed.absolute) {
+                status = "improved";
+            }
+            std::ostringstream changeText;
+            changeText << std::showpos << std::fixed << std::setprecision(1) << change << '%';
+            std::cout << std::setw(14) << actual << std::setw(10) << changeText.str() << "  " << status << "\n";
+        }
+        for (const auto& [name, value] : current) {
+            if (baseline.find(metricsPrefix + name) == baseline.end()) {
+                std::cout << std::left << std::setw(72) << name << std::right << std::setw(14) << "-"
+                    << std::setw(14) << value << std::setw(10) << "-" << "  new\n";
+            }
+        }
+        std::cout << "[perf-gate] " << compared << " metrics compared, " << regressions << " regressions\n";
+        return regressions;
+    }
+}
+
+bool PerfGate::parseOptions(int argc, char** argv, Options& options) {
+    // A smaller fixed suite than plain --bench so the gate stays quick;
+    // --bench-* flags still override it.
+    options.bench.levelWidths = { 1000 };
+    options.bench.entityCounts = { 100 };
+    options.bench.minSecondsPerCase = 0.1;
+    if (!Benchmarks::parseOptions(argc, argv, options.bench)) {
+        return false;
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--perf-gate") == 0 && hasValue) {
+            options.baselinePath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--perf-gate-update") == 0 && hasValue) {
+            options.baselinePath = argv[++i];
+            options.updateBaseline = true;
+        }
+        else if (std::strcmp(argv[i], "--perf-frames") == 0 && hasValue) {
+            if (!CommandLine::parseNumber(argv[++i], options.framesPerLevel)) {
+                return CommandLine::reject("[perf-gate]", "--perf-frames", "an integer", argv[i]);
+            }
+        }
+        else if (std::strcmp(argv[i], "--perf-no-bench") == 0) {
+            options.runBenchmarks = false;
+        }
+    }
+    return true;
+}
+
+int PerfGate::run(const Options& options) {
+    MetricValues baseline;
+    if (!options.updateBaseline) {
+        std::ifstream in(options.baselinePath);
+        if (!in.is_open()) {
+            std::cerr << "[perf-gate] could not read baseline " << options.baselinePath
+                << " (record one with --perf-gate-update)\n";
+            return 2;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        try {
+            baseline = JsonReader(text.str()).parse();
+        }
+        catch (const std::exception& error) {
+            std::cerr << "[perf-gate] " << options.baselinePath << ": " << error.what() << "\n";
+            return 2;
+        }
+    }
+
+    MetricValues current;
+    try {
+        current = measureLevels(options);
+        if (options.runBenchmarks) {
+            current.merge(measureBenchmarks(options));
+        }
+    }
+    catch (const std::exception& error) {
+        std::cerr << "[perf-gate] failed: " << error.what() << "\n";
+        return 2;
+    }
+
+    if (options.updateBaseline) {
+        return writeBaseline(options, current) ? 0 : 2;
+    }
+    const bool fullBenchSuite = options.runBenchmarks && options.bench.filter.empty();
+    return compare(baseline, current, fullBenchSuite) == 0 ? 0 : 1;
+}
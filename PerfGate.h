@@ -0,0 +1,28 @@
+#pragma once
+#include "Benchmarks.h"
+#include <string>
+
+// Performance regression gate, run with `--perf-gate <baseline.json>`. Plays
+// every level headless with scripted input, runs a reduced benchmark suite,
+// and compares frame-time percentiles, allocations per frame, level load time
+// and ns/op against the baseline. Exits non-zero when any metric is worse than
+// its tolerance allows; `--perf-gate-update` records a new baseline instead.
+// Allocations are only measured in ENGINE_ALLOC_TRACKING=1 builds, which is
+// what the gate's baseline should be recorded and checked with.
+namespace PerfGate {
+    struct Options {
+        std::string baselinePath;
+        bool updateBaseline = false;
+        int framesPerLevel = 600;
+        float dt = 1.f / 60.f;
+        bool runBenchmarks = true;
+        Benchmarks::Options bench;
+    };
+
+    // Reads --perf-gate, --perf-gate-update, --perf-* and --bench-* flags
+    // into options. False, after printing why, when a value is malformed.
+    bool parseOptions(int argc, char** argv, Options& options);
+
+    // 0 when within tolerance, 1 on regression, 2 when the gate couldn't run.
+    int run(const Options& options);
+}
@@ -2,6 +2,8 @@
 #include "Component.h"
 #include "TransformComponent.h"
 #include "Tilemap.h"
+#include "TileCollision.h"
+#include "Input.h"
 #include <SFML/Window/Keyboard.hpp>
 #include <algorithm>
 
@@ -24,6 +26,10 @@ public:
     bool jumpHeldLastFrame = false;
     float colliderWidth = 32.f;
     float colliderHeight = 48.f;
+    float groundFriction = 1.f; // friction of the tile last landed on
+    bool hitCeiling = false;    // set for the frame a jump hits a tile from below
+    int groundPlatform = -1;    // moving platform stood on, or -1
+    sf::Vector2i ceilingTile{ 0, 0 };
 
 
     PhysicsComponent(TransformComponent* transform, Tilemap* tilemap,
@@ -38,7 +44,7 @@ public:
     void update(float dt) override {
         if (!enabled || !transform || !tilemap) return;
 
-        const bool jumpPressed = allowJumpInput && sf::Keyboard::isKeyPressed(sf::Keyboard::Space);
+        const bool jumpPressed = allowJumpInput && Input::isKeyPressed(sf::Keyboard::Space);
         if (jumpPressed && !jumpHeldLastFrame) {
             jumpBufferTimer = jumpBufferTime;
 
@@ -64,58 +70,34 @@ public:
         if (!jumpPressed && jumpHeldLastFrame && velocityY < 0.f) {
             velocityY *= jumpCutMultiplier;
         }
-        // Apply gravity
-        velocityY += gravity * dt;
-
-        const float newY = transform->position.y + velocityY * dt;
-
-        const int tileXLeft = static_cast<int>(transform->position.x) / tilemap->tileSize;
-        const int tileXRight = static_cast<int>(transform->position.x + colliderWidth - 1.f) / tilemap->tileSize;
-        if (velocityY >= 0.f) {
-
-            const float feetY = newY + colliderHeight - 1.f;
-            const int tileY = static_cast<int>(feetY) / tilemap->tileSize;
-
-            bool collided = false;
-            for (int x = tileXLeft; x <= tileXRight; ++x) {
-                if (tilemap->isSolid(x, tileY)) {
-                    transform->position.y = tileY * tilemap->tileSize - colliderHeight;
-                    velocityY = 0.f;
-                    onGround = true;
-                    collided = true;
-                    break;
-
-                }
-            }
-            if (!collided) {
-                transform->position.y = newY;
-                onGround = false;
-
+        // Ride the platform stood on last tick; platforms have already moved
+        // this tick, so the rider keeps its footing before gravity applies.
+        if (onGround && groundPlatform >= 0) {
+            const sf::Vector2f carry = tilemap->platforms.getDelta(groundPlatform);
+            if (carry.x != 0.f || carry.y != 0.f) {
+                transform->position = TileCollision::sweep(*tilemap, transform->position,
+                    { colliderWidth, colliderHeight }, carry).position;
             }
-
-
-
         }
-        else {
-            const float headY = newY;
-            const int tileY = static_cast<int>(headY) / tilemap->tileSize;
-
-            bool collided = false;
-            for (int x = tileXLeft; x <= tileXRight; ++x) {
-                if (tilemap->isSolid(x, tileY)) {
-                    transform->position.y = (tileY + 1) * tilemap->tileSize;
-                    velocityY = 0.f;
-                    collided = true;
-                    break;
-
-                }
-            }
-            if (!collided) {
-                transform->position.y = newY;
 
-            }
-            onGround = false;
+        // Apply gravity
+        velocityY += gravity * dt;
 
+        const TileCollision::Result contact = TileCollision::sweep(*tilemap, transform->position,
+            { colliderWidth, colliderHeight }, { 0.f, velocityY * dt });
+        transform->position = contact.position;
+        if (contact.hitY()) {
+            velocityY = 0.f;
+        }
+        onGround = contact.normal.y < 0;
+        groundPlatform = onGround ? contact.platform : -1;
+        hitCeiling = contact.normal.y > 0;
+        if (hitCeiling) {
+            ceilingTile = contact.tileY;
+        }
+        if (onGround) {
+            groundFriction = contact.platform >= 0
+                ? 1.f : tilemap->getTileProperties(contact.tileY.x, contact.tileY.y).friction;
         }
         jumpHeldLastFrame = jumpPressed;
     }
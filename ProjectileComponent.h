@@ -2,11 +2,14 @@
 #include "Component.h"
 #include "TransformComponent.h"
 #include "Tilemap.h"
+#include "TileCollision.h"
 #include "Scene.h"
 #include "EnemyComponent.h"
 #include "PhysicsComponent.h"
 #include "SpriteComponent.h"
 #include "AnimationComponent.h"
+#include "ParticleSystem.h"
+#include "Metrics.h"
 #include <algorithm>
 
 class ProjectileComponent : public Component {
@@ -19,7 +22,8 @@ public:
         float colliderWidth,
         float colliderHeight,
         float lifetime,
-        float gravity = 0.f)
+        float gravity = 0.f,
+        ParticleSystem* particles = nullptr)
         : transform(transform),
         tilemap(tilemap),
         scene(scene),
@@ -28,7 +32,13 @@ public:
         colliderWidth(colliderWidth),
         colliderHeight(colliderHeight),
         lifetime(lifetime),
-        gravity(gravity) {
+        gravity(gravity),
+        particles(particles) {
+        Metrics::add(MetricGauge::Projectiles, 1);
+    }
+
+    ~ProjectileComponent() override {
+        Metrics::add(MetricGauge::Projectiles, -1);
     }
 
     void update(float dt) override {
@@ -41,24 +51,42 @@ public:
             return;
         }
 
+        // Thrown from inside a wall: hit whatever it started in rather than
+        // letting the sweep push it out on the far side.
+        const Tilemap::TileHit inside = tilemap->queryOverlap(
+            sf::FloatRect(transform->position, { colliderWidth, colliderHeight }));
+        if (inside.hit) {
+            tilemap->breakTile(inside.tile.x, inside.tile.y);
+            emitImpact(transform->position);
+            entity->destroy();
+            return;
+        }
+
         if (gravity != 0.f) {
             velocityY += gravity * dt;
         }
 
-        sf::Vector2f nextPosition = {
-            transform->position.x + velocityX * dt,
-            transform->position.y + velocityY * dt
-        };
-
-        if (collidesWithSolid(nextPosition)) {
+        const TileCollision::Result contact = TileCollision::sweep(*tilemap, transform->position,
+            { colliderWidth, colliderHeight }, { velocityX * dt, velocityY * dt });
+        if (contact.hit()) {
+            // Bricks shatter; anything else just stops the projectile.
+            if (contact.hitX()) {
+                tilemap->breakTile(contact.tileX.x, contact.tileX.y);
+            }
+            if (contact.hitY()) {
+                tilemap->breakTile(contact.tileY.x, contact.tileY.y);
+            }
+            emitImpact(contact.position);
             entity->destroy();
             return;
         }
+        const sf::Vector2f nextPosition = contact.position;
 
         transform->position = nextPosition;
 
         if (scene) {
             if (checkEnemyHit()) {
+                emitImpact(transform->position);
                 entity->destroy();
                 return;
             }
@@ -84,26 +112,13 @@ private:
     float colliderHeight = 16.f;
     float lifetime = 0.f;
     float gravity = 0.f;
+    ParticleSystem* particles = nullptr;
 
-    bool collidesWithSolid(const sf::Vector2f& position) const {
-        const float leftX = position.x;
-        const float rightX = position.x + colliderWidth - 1.f;
-        const float topY = position.y;
-        const float bottomY = position.y + colliderHeight - 1.f;
-
-        const int tileXLeft = static_cast<int>(leftX) / tilemap->tileSize;
-        const int tileXRight = static_cast<int>(rightX) / tilemap->tileSize;
-        const int tileYTop = static_cast<int>(topY) / tilemap->tileSize;
-        const int tileYBottom = static_cast<int>(bottomY) / tilemap->tileSize;
-
-        for (int y = tileYTop; y <= tileYBottom; ++y) {
-            for (int x = tileXLeft; x <= tileXRight; ++x) {
-                if (tilemap->isSolid(x, y)) {
-                    return true;
-                }
-            }
+    void emitImpact(sf::Vector2f position) {
+        if (particles) {
+            particles->emit(position + sf::Vector2f(colliderWidth / 2.f, colliderHeight / 2.f),
+                ParticleSystem::makeBurst(10, sf::Color(255, 150, 40), 3.f));
         }
-        return false;
     }
 
     bool checkEnemyHit() const {
@@ -134,19 +149,7 @@ private:
                 continue;
             }
 
-            enemy->alive = false;
-            enemy->deathTimer = enemy->deathDelay;
-            if (PhysicsComponent* enemyPhysics = other->getComponent<PhysicsComponent>()) {
-                enemyPhysics->velocityY = 0.f;
-                enemyPhysics->onGround = true;
-            }
-            if (SpriteComponent* sprite = other->getComponent<SpriteComponent>()) {
-                const float currentXScale = sprite->getSprite().getScale().x;
-                sprite->getSprite().setScale(currentXScale, 0.25f);
-            }
-            if (AnimationComponent* anim = other->getComponent<AnimationComponent>()) {
-                anim->paused = true;
-            }
+            enemy->kill();
             return true;
         }
         return false;
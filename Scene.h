@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <SFML/Graphics.hpp>
 #include "Entity.h"
+#include "Metrics.h"
 
 class Scene {
 
@@ -29,6 +30,7 @@ public:
 			std::remove_if(entities.begin(), entities.end(),
 				[](const std::unique_ptr<Entity>& e) { return !e->isActive(); }),
 			entities.end());
+		Metrics::set(MetricGauge::LiveEntities, static_cast<std::int64_t>(entities.size()));
 
 
 	}
@@ -39,6 +41,7 @@ public:
 	}
 	void clear() {
 		entities.clear();
+		Metrics::set(MetricGauge::LiveEntities, 0);
 
 	}
 	
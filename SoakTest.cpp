@@ -0,0 +1,267 @@
+#include "SoakTest.h"
+#include "EngineCore.h"
+#include "Metrics.h"
+#include "CommandLine.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace {
+    struct Sample {
+        int cycle = 0;
+        int level = 0;
+        double elapsedSeconds = 0.0;
+        double simulatedSeconds = 0.0;
+        std::uint64_t residentBytes = 0;
+        std::size_t entities = 0;
+        std::int64_t textures = 0;
+        std::int64_t textureBytes = 0;
+        double frameP50 = 0.0;
+        double frameP99 = 0.0;
+        double loadMilliseconds = 0.0;
+        int restarts = 0;
+    };
+
+    // 0 where the platform offers no cheap query.
+    std::uint64_t residentBytes() {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters{};
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<std::uint64_t>(counters.WorkingSetSize);
+        }
+        return 0;
+#elif defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        std::uint64_t pages = 0;
+        std::uint64_t resident = 0;
+        if (statm >> pages >> resident) {
+            return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+        }
+        return 0;
+#else
+        return 0;
+#endif
+    }
+
+    template <typename Value>
+    double mean(const std::vector<const Sample*>& samples, Value value) {
+        double sum = 0.0;
+        for (const Sample* sample : samples) {
+            sum += static_cast<double>(value(*sample));
+        }
+        return samples.empty() ? 0.0 : sum / static_cast<double>(samples.size());
+    }
+
+    template <typename Value>
+    double maximum(const std::vector<const Sample*>& samples, Value value) {
+        double result = 0.0;
+        for (const Sample* sample : samples) {
+            result = std::max(result, static_cast<double>(value(*sample)));
+        }
+        return result;
+    }
+
+    // Compares the first and last quarter of the post-warmup samples, which
+    // smooths out one-off spikes without hiding steady growth.
+    struct Windows {
+        std::vector<const Sample*> early;
+        std::vector<const Sample*> late;
+    };
+
+    Windows splitWindows(const std::vector<const Sample*>& samples) {
+        Windows windows;
+        const std::size_t quarter = std::max<std::size_t>(1, samples.size() / 4);
+        windows.early.assign(samples.begin(), samples.begin() + quarter);
+        windows.late.assign(samples.end() - quarter, samples.end());
+        return windows;
+    }
+
+    void writeSamples(const std::string& path, const std::vector<Sample>& samples) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out.is_open()) {
+            std::cerr << "[soak] could not write " << path << "\n";
+            return;
+        }
+        out << "cycle,level,elapsed_s,simulated_s,rss_bytes,entities,textures,texture_bytes,"
+            "frame_p50_ms,frame_p99_ms,load_ms,restarts\n";
+        for (const Sample& sample : samples) {
+            out << sample.cycle << ',' << sample.level << ',' << sample.elapsedSeconds << ','
+                << sample.simulatedSeconds << ',' << sample.residentBytes << ',' << sample.entities << ','
+                << sample.textures << ',' << sample.textureBytes << ',' << sample.frameP50 << ','
+                << sample.frameP99 << ',' << sample.loadMilliseconds << ',' << sample.restarts << '\n';
+        }
+    }
+
+    // Prints one verdict line per check and returns the number of failures.
+    int analyse(const SoakTest::Options& options, const std::vector<Sample>& samples, int levelCount) {
+        std::vector<const Sample*> measured;
+        for (const Sample& sample : samples) {
+            if (sample.cycle >= options.warmupCycles) {
+                measured.push_back(&sample);
+            }
+        }
+        int failures = 0;
+        const auto verdict = [&](bool failed) {
+            failures += failed ? 1 : 0;
+            return failed ? "GROWTH" : "ok";
+        };
+
+        const Windows process = splitWindows(measured);
+        const double earlyRss = mean(process.early, [](const Sample& s) { return s.residentBytes; }) / (1024.0 * 1024.0);
+        const double lateRss = mean(process.late, [](const Sample& s) { return s.residentBytes; }) / (1024.0 * 1024.0);
+        std::cout << "[soak] rss " << earlyRss << " MB -> " << lateRss << " MB: "
+            << verdict(lateRss - earlyRss > options.rssGrowthLimitMB) << "\n";
+
+        for (int level = 0; level < levelCount; ++level) {
+            std::vector<const Sample*> levelSamples;
+            for (const Sample* sample : measured) {
+                if (sample->level == level) {
+                    levelSamples.push_back(sample);
+                }
+            }
+            if (levelSamples.size() < 2) {
+                continue;
+            }
+            // The script and dt are fixed, so each visit to a level should
+            // end with the same entities and textures.
+            const Windows windows = splitWindows(levelSamples);
+            const auto entities = [](const Sample& s) { return s.entities; };
+            const auto textures = [](const Sample& s) { return s.textures; };
+            const auto textureBytes = [](const Sample& s) { return s.textureBytes; };
+            const auto frameP50 = [](const Sample& s) { return s.frameP50; };
+            const auto load = [](const Sample& s) { return s.loadMilliseconds; };
+
+            const double earlyEntities = maximum(windows.early, entities);
+            const double lateEntities = maximum(windows.late, entities);
+            const double earlyTextureBytes = maximum(windows.early, textureBytes);
+            const double lateTextureBytes = maximum(windows.late, textureBytes);
+            const double earlyFrame = mean(windows.early, frameP50);
+            const double lateFrame = mean(windows.late, frameP50);
+            const double earlyLoad = mean(windows.early, load);
+            const double lateLoad = mean(windows.late, load);
+
+            std::cout << "[soak] level " << level << " entities " << earlyEntities << " -> " << lateEntities << ": "
+                << verdict(lateEntities > earlyEntities + options.entityGrowthLimit) << "\n";
+            std::cout << "[soak] level " << level << " textures " << maximum(windows.early, textures) << " -> "
+                << maximum(windows.late, textures) << " (" << earlyTextureBytes << " -> " << lateTextureBytes
+                << " bytes): " << verdict(lateTextureBytes > earlyTextureBytes) << "\n";
+            std::cout << "[soak] level " << level << " frame p50 " << earlyFrame << " ms -> " << lateFrame << " ms: "
+                << verdict(lateFrame > earlyFrame * (1.0 + options.frameDriftLimit)
+                    && lateFrame - earlyFrame > options.frameDriftFloorMs) << "\n";
+            std::cout << "[soak] level " << level << " load " << earlyLoad << " ms -> " << lateLoad << " ms: "
+                << verdict(lateLoad > earlyLoad * (1.0 + options.loadDriftLimit)
+                    && lateLoad - earlyLoad > options.loadDriftFloorMs) << "\n";
+        }
+        return failures;
+    }
+}
+
+bool SoakTest::parseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const bool hasValue = i + 1 < argc;
+        const char* flag = argv[i];
+        bool valid = true;
+        const char* expected = "a number";
+        if (std::strcmp(flag, "--soak-minutes") == 0 && hasValue) {
+            valid = CommandLine::parseNumber(argv[++i], options.minutes);
+        }
+        else if (std::strcmp(flag, "--soak-cycles") == 0 && hasValue) {
+            valid = CommandLine::parseNumber(argv[++i], options.maxCycles);
+            expected = "an integer";
+        }
+        else if (std::strcmp(flag, "--soak-frames") == 0 && hasValue) {
+            valid = CommandLine::parseNumber(argv[++i], options.framesPerLevel);
+            expected = "an integer";
+        }
+        else if (std::strcmp(flag, "--soak-reset-interval") == 0 && hasValue) {
+            valid = CommandLine::parseNumber(argv[++i], options.resetInterval);
+            expected = "an integer";
+        }
+        else if (std::strcmp(flag, "--soak-out") == 0 && hasValue) {
+            options.outputPath = argv[++i];
+        }
+        else if (std::strcmp(flag, "--soak-rss-limit-mb") == 0 && hasValue) {
+            valid = CommandLine::parseNumber(argv[++i], options.rssGrowthLimitMB);
+        }
+        else if (std::strcmp(flag, "--soak-frame-drift") == 0 && hasValue) {
+            valid = CommandLine::parseNumber(argv[++i], options.frameDriftLimit);
+        }
+        if (!valid) {
+            return CommandLine::reject("[soak]", flag, expected, argv[i]);
+        }
+    }
+    return true;
+}
+
+int SoakTest::run(const Options& options) {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const auto elapsedSeconds = [&start] {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    EngineCore engine(true);
+    const int levelCount = engine.getLevelCount();
+    if (levelCount == 0) {
+        std::cerr << "[soak] no levels to play\n";
+        return 2;
+    }
+    if (!Metrics::enabled) {
+        std::cerr << "[soak] built without ENGINE_METRICS; texture counts will read 0\n";
+    }
+
+    std::vector<Sample> samples;
+    double simulatedSeconds = 0.0;
+    int cycle = 0;
+    while ((options.maxCycles <= 0 || cycle < options.maxCycles)
+        && elapsedSeconds() < options.minutes * 60.0) {
+        for (int level = 0; level < levelCount; ++level) {
+            const EngineCore::HeadlessLevelStats stats =
+                engine.runHeadlessLevel(level, options.framesPerLevel, options.dt, options.resetInterval);
+            simulatedSeconds += static_cast<double>(options.framesPerLevel) * options.dt;
+
+            Sample sample;
+            sample.cycle = cycle;
+            sample.level = level;
+            sample.elapsedSeconds = elapsedSeconds();
+            sample.simulatedSeconds = simulatedSeconds;
+            sample.residentBytes = residentBytes();
+            sample.entities = stats.liveEntities;
+            sample.textures = Metrics::get(MetricGauge::Textures);
+            sample.textureBytes = Metrics::get(MetricGauge::TextureBytes);
+            sample.frameP50 = EngineCore::HeadlessLevelStats::percentile(stats.frameMilliseconds, 0.50);
+            sample.frameP99 = EngineCore::HeadlessLevelStats::percentile(stats.frameMilliseconds, 0.99);
+            sample.loadMilliseconds = stats.loadMilliseconds;
+            sample.restarts = stats.restarts;
+            samples.push_back(sample);
+        }
+        ++cycle;
+        const Sample& last = samples.back();
+        std::cerr << "[soak] cycle " << cycle << ": " << last.elapsedSeconds << " s real, "
+            << last.simulatedSeconds << " s simulated, rss " << last.residentBytes / (1024 * 1024) << " MB\n";
+    }
+    writeSamples(options.outputPath, samples);
+
+    if (cycle - options.warmupCycles < 4) {
+        std::cerr << "[soak] only " << cycle << " cycles ran; at least " << options.warmupCycles + 4
+            << " are needed to judge growth\n";
+        return 2;
+    }
+    const int failures = analyse(options, samples, levelCount);
+    std::cout << "[soak] " << cycle << " cycles, " << simulatedSeconds / 3600.0 << " simulated hours, "
+        << failures << " checks failed\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+
+// Long-running headless soak, run with `--soak`. Cycles through every level
+// with scripted play (deaths, power-ups, level resets and reloads included)
+// as fast as the machine allows, samples memory, entity and texture counts
+// and frame times after each level, and flags growth or drift between the
+// start and the end of the run.
+namespace SoakTest {
+    struct Options {
+        double minutes = 60.0;         // wall-clock budget
+        int maxCycles = 0;             // 0 runs until the time budget is spent
+        int framesPerLevel = 3600;     // one simulated minute per level visit
+        float dt = 1.f / 60.f;
+        int resetInterval = 1200;      // frames between scripted level resets
+        int warmupCycles = 1;          // excluded from the comparison
+        std::string outputPath = "soak.csv";
+
+        double rssGrowthLimitMB = 32.0;
+        int entityGrowthLimit = 0;
+        double frameDriftLimit = 0.25;      // relative, on per-level p50
+        double frameDriftFloorMs = 0.05;    // smaller changes are noise
+        double loadDriftLimit = 0.5;
+        double loadDriftFloorMs = 0.5;
+    };
+
+    // Reads --soak-* flags into options; anything else is left for the
+    // caller. False, after printing why, when a value is malformed.
+    bool parseOptions(int argc, char** argv, Options& options);
+
+    // 0 when nothing grew or drifted, 1 when something did, 2 when the soak
+    // couldn't run long enough to judge.
+    int run(const Options& options);
+}
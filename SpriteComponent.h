@@ -1,9 +1,11 @@
 ﻿#pragma once
 #include "Component.h"
 #include "TransformComponent.h"
+#include "TextureAtlas.h"
+#include "Logger.h"
+#include "Metrics.h"
 #include <SFML/Graphics.hpp>
 #include <string>
-#include <iostream>
 
 class SpriteComponent : public Component {
 public:
@@ -17,16 +19,26 @@ public:
         : transform(transform)
     {
         if (!texture.loadFromFile(textureFile)) {
-            std::cout << "FAILED TO LOAD SPRITE\n";
+            Log::error(LogCategory::Assets, "Failed to load sprite %s", textureFile.c_str());
         }
+        textureMetric.set(texture);
 
         sprite.setTexture(texture);
+        resetRegionToTexture();
 
 
         // ✅ Center origin ONCE
         sprite.setOrigin(frameWidth / 2.f, frameHeight / 2.f);
     }
 
+    SpriteComponent(const TextureAtlas::Region& atlasRegion, TransformComponent* transform)
+        : transform(transform)
+    {
+        setRegion(atlasRegion);
+
+        sprite.setOrigin(frameWidth / 2.f, frameHeight / 2.f);
+    }
+
     void update(float dt) override {
         // ✅ Keep physics + rendering aligned
         sprite.setPosition(
@@ -37,18 +49,36 @@ public:
     void render(sf::RenderTarget& target) override {
         if (!visible) return;
         target.draw(sprite);
+        Metrics::count(MetricCounter::DrawCalls);
     }
 
     sf::Sprite& getSprite() { return sprite; }
     
     bool setTexture(const std::string& textureFile) {
         if (!texture.loadFromFile(textureFile)) {
-            std::cout << "FAILED TO LOAD SPRITE\n";
+            Log::error(LogCategory::Assets, "Failed to load sprite %s", textureFile.c_str());
         }
+        textureMetric.set(texture);
         sprite.setTexture(texture, true);
+        resetRegionToTexture();
         return true;
     }
 
+    // Draws from a shared atlas page instead of an owned texture.
+    void setRegion(const TextureAtlas::Region& atlasRegion) {
+        sprite.setTexture(*atlasRegion.texture);
+        sprite.setTextureRect(atlasRegion.rect);
+        region = atlasRegion.rect;
+        regionImage = atlasRegion.image;
+    }
+
+    // The part of the bound texture that holds this sprite's image; frame
+    // rects are relative to its top-left corner.
+    const sf::IntRect& getTextureRegion() const { return region; }
+
+    // CPU pixels for the region's texture when available (atlas pages keep one).
+    const sf::Image* getRegionImage() const { return regionImage; }
+
     // ✅ Flip using scale ONLY
     void setFlipped(bool flip) {
         if (flipped == flip) return;
@@ -65,5 +95,14 @@ public:
 private:
     TransformComponent* transform;
     sf::Texture texture;
+    TextureMetric textureMetric;
     sf::Sprite sprite;
+    sf::IntRect region;
+    const sf::Image* regionImage = nullptr;
+
+    void resetRegionToTexture() {
+        const sf::Vector2u size = texture.getSize();
+        region = sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+        regionImage = nullptr;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <algorithm>
+#include <numeric>
+#include "Logger.h"
+#include "Metrics.h"
+
+// Packs many images into a few large pages so consecutive draws of different
+// sprites (tiles, powerups, player, enemies) share one texture binding.
+class TextureAtlas {
+public:
+    struct Source {
+        std::string key;
+        std::string path;
+        bool trim = false; // only safe for single-frame images, never sheets
+    };
+
+    struct Region {
+        const sf::Texture* texture = nullptr;
+        const sf::Image* image = nullptr; // CPU copy of the page, avoids GPU readback
+        sf::IntRect rect;                 // trimmed pixels inside the page
+        sf::Vector2i sourceSize;          // original image size before trimming
+        sf::Vector2i trimOffset;          // rect's top-left inside the original image
+    };
+
+    // CPU-side packing result; built off the main thread, uploaded by install().
+    struct Layout {
+        struct Entry {
+            std::string key;
+            std::size_t page = 0;
+            sf::IntRect rect;
+            sf::Vector2i sourceSize;
+            sf::Vector2i trimOffset;
+        };
+        std::vector<sf::Image> pages;
+        std::vector<Entry> entries;
+    };
+
+    static constexpr unsigned int pageSize = 4096;
+    static constexpr unsigned int padding = 1;
+
+    static Layout pack(const std::vector<Source>& sources) {
+        struct Decoded {
+            std::string key;
+            sf::Image image;
+            sf::IntRect trimmed;
+        };
+        std::vector<Decoded> decoded;
+        decoded.reserve(sources.size());
+        for (const Source& source : sources) {
+            Decoded item;
+            if (!item.image.loadFromFile(source.path)) {
+                Log::error(LogCategory::Assets, "Atlas: failed to load %s", source.path.c_str());
+                continue;
+            }
+            const sf::Vector2u size = item.image.getSize();
+            item.trimmed = source.trim
+                ? opaqueBounds(item.image)
+                : sf::IntRect(0, 0, static_cast<int>(size.x), static_cast<int>(size.y));
+            item.key = source.key;
+            decoded.push_back(std::move(item));
+        }
+
+        // Tallest first keeps shelves tight.
+        std::vector<std::size_t> order(decoded.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return decoded[a].trimmed.height > decoded[b].trimmed.height;
+        });
+
+        struct Shelf {
+            unsigned int width = 0;
+            unsigned int penX = padding;
+            unsigned int penY = padding;
+            unsigned int rowHeight = 0;
+            unsigned int usedHeight = 0;
+        };
+        std::vector<Shelf> shelves;
+        Layout layout;
+        for (std::size_t index : order) {
+            const Decoded& item = decoded[index];
+            const unsigned int w = static_cast<unsigned int>(item.trimmed.width);
+            const unsigned int h = static_cast<unsigned int>(item.trimmed.height);
+
+            std::size_t page = shelves.size();
+            if (w + 2 * padding > pageSize || h + 2 * padding > pageSize) {
+                // Oversized images get a page of their own.
+                Shelf shelf;
+                shelf.width = w + 2 * padding;
+                shelves.push_back(shelf);
+            }
+            else {
+                if (!shelves.empty() && shelves.back().width == pageSize) {
+                    Shelf& shelf = shelves.back();
+                    if (shelf.penX + w + padding > pageSize) {
+                        shelf.penX = padding;
+                        shelf.penY += shelf.rowHeight + padding;
+                        shelf.rowHeight = 0;
+                    }
+                    if (shelf.penY + h + padding <= pageSize) {
+                        page = shelves.size() - 1;
+                    }
+                }
+                if (page == shelves.size()) {
+                    Shelf shelf;
+                    shelf.width = pageSize;
+                    shelves.push_back(shelf);
+                }
+            }
+            Shelf& shelf = shelves[page];
+            Layout::Entry entry;
+            entry.key = item.key;
+            entry.page = page;
+            entry.rect = sf::IntRect(static_cast<int>(shelf.penX), static_cast<int>(shelf.penY),
+                item.trimmed.width, item.trimmed.height);
+            const sf::Vector2u sourceSize = item.image.getSize();
+            entry.sourceSize = sf::Vector2i(static_cast<int>(sourceSize.x), static_cast<int>(sourceSize.y));
+            entry.trimOffset = sf::Vector2i(item.trimmed.left, item.trimmed.top);
+            shelf.penX += w + padding;
+            shelf.rowHeight = std::max(shelf.rowHeight, h);
+            shelf.usedHeight = std::max(shelf.usedHeight, shelf.penY + h + padding);
+            layout.entries.push_back(entry);
+        }
+
+        layout.pages.resize(shelves.size());
+        for (std::size_t i = 0; i < shelves.size(); ++i) {
+            layout.pages[i].create(shelves[i].width, std::max(1u, shelves[i].usedHeight), sf::Color::Transparent);
+        }
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            const Decoded& item = decoded[order[i]];
+            const Layout::Entry& entry = layout.entries[i];
+            layout.pages[entry.page].copy(item.image,
+                static_cast<unsigned int>(entry.rect.left),
+                static_cast<unsigned int>(entry.rect.top),
+                item.trimmed);
+        }
+        return layout;
+    }
+
+    // Uploads packed pages. Must run on the thread owning the GL context.
+    bool install(Layout&& layout) {
+        pageTextures.clear();
+        pageImages.clear();
+        regions.clear();
+        pageTextureMetric.assign(0, 0);
+        for (sf::Image& page : layout.pages) {
+            auto texture = std::make_unique<sf::Texture>();
+            if (!texture->loadFromImage(page)) {
+                Log::error(LogCategory::Assets, "Atlas: failed to upload %ux%u page", page.getSize().x, page.getSize().y);
+                pageTextures.clear();
+                pageImages.clear();
+                return false;
+            }
+            pageTextures.push_back(std::move(texture));
+            pageImages.push_back(std::make_unique<sf::Image>(std::move(page)));
+        }
+        std::int64_t pageBytes = 0;
+        for (const auto& texture : pageTextures) {
+            pageBytes += static_cast<std::int64_t>(texture->getSize().x) * texture->getSize().y * 4;
+        }
+        pageTextureMetric.assign(static_cast<std::int64_t>(pageTextures.size()), pageBytes);
+        for (const Layout::Entry& entry : layout.entries) {
+            Region region;
+            region.texture = pageTextures[entry.page].get();
+            region.image = pageImages[entry.page].get();
+            region.rect = entry.rect;
+            region.sourceSize = entry.sourceSize;
+            region.trimOffset = entry.trimOffset;
+            regions[entry.key] = region;
+        }
+        Log::info(LogCategory::Assets, "Atlas: packed %zu images into %zu page(s).", regions.size(), pageTextures.size());
+        return true;
+    }
+
+    const Region* find(const std::string& key) const {
+        const auto it = regions.find(key);
+        return it != regions.end() ? &it->second : nullptr;
+    }
+
+    std::size_t getPageCount() const {
+        return pageTextures.size();
+    }
+
+private:
+    std::vector<std::unique_ptr<sf::Texture>> pageTextures;
+    TextureMetric pageTextureMetric;
+    std::vector<std::unique_ptr<sf::Image>> pageImages;
+    std::unordered_map<std::string, Region> regions;
+
+    static sf::IntRect opaqueBounds(const sf::Image& image) {
+        const sf::Vector2u size = image.getSize();
+        const sf::Uint8* pixels = image.getPixelsPtr();
+        int minX = static_cast<int>(size.x);
+        int minY = static_cast<int>(size.y);
+        int maxX = -1;
+        int maxY = -1;
+        for (unsigned int y = 0; y < size.y; ++y) {
+            const sf::Uint8* row = pixels + static_cast<std::size_t>(y) * size.x * 4;
+            for (unsigned int x = 0; x < size.x; ++x) {
+                if (row[x * 4 + 3] == 0)
+                    continue;
+                minX = std::min(minX, static_cast<int>(x));
+                maxX = std::max(maxX, static_cast<int>(x));
+                minY = std::min(minY, static_cast<int>(y));
+                maxY = std::max(maxY, static_cast<int>(y));
+            }
+        }
+        if (maxX < 0) {
+            return sf::IntRect(0, 0, 1, 1);
+        }
+        return sf::IntRect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+    }
+};
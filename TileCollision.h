@@ -0,0 +1,211 @@
+#pragma once
+#include "Tilemap.h"
+#include "MovingPlatforms.h"
+#include "Metrics.h"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
+
+// Swept AABB against the tile grid, shared by every mover. A body that starts
+// inside solid tiles (spawned into the floor, or a brick restored on top of
+// it) is first pushed out the shortest way. Each axis is then swept through
+// all tile rows/columns the leading edge crosses, so fast bodies stop at the
+// first solid tile instead of tunnelling through it. X resolves first, then
+// Y from the corrected X position. One-way tiles and moving platforms only
+// block the downward Y sweep, and only below the body's starting bottom edge.
+class TileCollision {
+public:
+    struct Result {
+        sf::Vector2f position;
+        // Points away from the surface that was hit, e.g. (0,-1) when landing.
+        sf::Vector2i normal;
+        // Tile that stopped the body on each axis; only valid when that axis hit.
+        sf::Vector2i tileX;
+        sf::Vector2i tileY;
+        // Moving platform landed on, or -1 when the Y contact was a tile.
+        int platform = -1;
+
+        bool hitX() const { return normal.x != 0; }
+        bool hitY() const { return normal.y != 0; }
+        bool hit() const { return hitX() || hitY(); }
+    };
+
+    struct Body {
+        sf::Vector2f position;
+        sf::Vector2f size;
+        sf::Vector2f delta;
+        Result result;
+    };
+
+    static Result sweep(const Tilemap& tilemap, sf::Vector2f position, sf::Vector2f size, sf::Vector2f delta) {
+        Result result{ position, sf::Vector2i(0, 0), sf::Vector2i(0, 0), sf::Vector2i(0, 0), -1 };
+        Metrics::count(MetricCounter::CollisionQueries);
+        if (tilemap.tileSize <= 0) {
+            result.position += delta;
+            return result;
+        }
+        pushOut(tilemap, result.position, size);
+        if (delta.x != 0.f) {
+            result.normal.x = sweepAxis(tilemap, result.position.x, size.x, delta.x,
+                result.position.y, size.y, true, Tilemap::TileFlag::Solid, result.tileX);
+        }
+        if (delta.y != 0.f) {
+            const std::uint8_t mask = delta.y > 0.f
+                ? Tilemap::TileFlag::Solid | Tilemap::TileFlag::OneWay
+                : Tilemap::TileFlag::Solid;
+            const float startBottom = result.position.y + size.y;
+            result.normal.y = sweepAxis(tilemap, result.position.y, size.y, delta.y,
+                result.position.x, size.x, false, static_cast<std::uint8_t>(mask), result.tileY);
+            if (delta.y > 0.f) {
+                landOnPlatform(tilemap.platforms, result, size, startBottom);
+            }
+        }
+        return result;
+    }
+
+    // Resolves every body against the same map in one pass; results are
+    // written back into each Body.
+    static void sweepAll(const Tilemap& tilemap, std::vector<Body>& bodies) {
+        for (Body& body : bodies) {
+            body.result = sweep(tilemap, body.position, body.size, body.delta);
+        }
+    }
+
+    static bool overlapsSolid(const Tilemap& tilemap, sf::Vector2f position, sf::Vector2f size) {
+        return tilemap.overlapsSolid(sf::FloatRect(position, size));
+    }
+
+private:
+    // Edges that land exactly on a tile boundary (as they do after a snap)
+    // must not count as touching the next tile; matches Tilemap::queryOverlap.
+    static constexpr float boundaryEpsilon = 0.001f;
+
+    static int firstCell(float minEdge, int tileSize) {
+        return static_cast<int>(std::floor((minEdge + boundaryEpsilon) / tileSize));
+    }
+
+    static int lastCell(float maxEdge, int tileSize) {
+        return static_cast<int>(std::floor((maxEdge - boundaryEpsilon) / tileSize));
+    }
+
+    // Riders are carried flush with the top, so allow a little slack when
+    // deciding whether a body started above a platform.
+    static constexpr float platformSlack = 1.f;
+
+    static void landOnPlatform(const MovingPlatforms& platforms, Result& result, sf::Vector2f size, float startBottom) {
+        if (platforms.empty()) {
+            return;
+        }
+        const float left = result.position.x;
+        const float right = result.position.x + size.x;
+        const float endBottom = result.position.y + size.y;
+        const sf::FloatRect swept(left, startBottom - platformSlack, size.x, endBottom - startBottom + platformSlack);
+        float bestTop = endBottom;
+        int bestPlatform = -1;
+        platforms.forEachNear(swept, [&](int index, const MovingPlatforms::Platform& platform) {
+            const float top = platform.position.y;
+            if (right - boundaryEpsilon <= platform.position.x
+                || left + boundaryEpsilon >= platform.position.x + platform.size.x) {
+                return;
+            }
+            if (top < startBottom - platformSlack || top > bestTop) {
+                return;
+            }
+            bestTop = top;
+            bestPlatform = index;
+        });
+        if (bestPlatform >= 0) {
+            result.position.y = bestTop - size.y;
+            result.normal.y = -1;
+            result.platform = bestPlatform;
+        }
+    }
+
+    // Moves a body overlapping solid tiles by the smallest of the four axis
+    // pushes that clears them all; left untouched if none does.
+    static void pushOut(const Tilemap& tilemap, sf::Vector2f& position, sf::Vector2f size) {
+        const int tileSize = tilemap.tileSize;
+        const int firstX = std::max(firstCell(position.x, tileSize), 0);
+        const int lastX = std::min(lastCell(position.x + size.x, tileSize), tilemap.getWidth() - 1);
+        const int firstY = std::max(firstCell(position.y, tileSize), 0);
+        const int lastY = std::min(lastCell(position.y + size.y, tileSize), tilemap.getHeight() - 1);
+        bool overlapping = false;
+        sf::Vector2i minSolid(lastX, lastY);
+        sf::Vector2i maxSolid(firstX, firstY);
+        for (int y = firstY; y <= lastY; ++y) {
+            for (int x = firstX; x <= lastX; ++x) {
+                if (tilemap.getTileFlags(x, y) & Tilemap::TileFlag::Solid) {
+                    overlapping = true;
+                    minSolid = sf::Vector2i(std::min(minSolid.x, x), std::min(minSolid.y, y));
+                    maxSolid = sf::Vector2i(std::max(maxSolid.x, x), std::max(maxSolid.y, y));
+                }
+            }
+        }
+        if (!overlapping) {
+            return;
+        }
+        const float tile = static_cast<float>(tileSize);
+        std::array<sf::Vector2f, 4> pushes = {
+            sf::Vector2f(0.f, minSolid.y * tile - (position.y + size.y)),
+            sf::Vector2f(0.f, (maxSolid.y + 1) * tile - position.y),
+            sf::Vector2f(minSolid.x * tile - (position.x + size.x), 0.f),
+            sf::Vector2f((maxSolid.x + 1) * tile - position.x, 0.f)
+        };
+        std::stable_sort(pushes.begin(), pushes.end(), [](sf::Vector2f a, sf::Vector2f b) {
+            return std::abs(a.x) + std::abs(a.y) < std::abs(b.x) + std::abs(b.y);
+        });
+        for (const sf::Vector2f& push : pushes) {
+            if (!tilemap.overlapsSolid(sf::FloatRect(position + push, size))) {
+                position += push;
+                return;
+            }
+        }
+    }
+
+    // Moves pos along one axis and returns the contact normal on that axis.
+    static int sweepAxis(const Tilemap& tilemap, float& pos, float size, float delta,
+        float crossPos, float crossSize, bool horizontal, std::uint8_t mask, sf::Vector2i& hitTile) {
+        const int tileSize = tilemap.tileSize;
+        const int crossFirst = firstCell(crossPos, tileSize);
+        const int crossLast = lastCell(crossPos + crossSize, tileSize);
+        // Nothing outside the map is solid, so the scan never leaves it.
+        const int mapCells = horizontal ? tilemap.getWidth() : tilemap.getHeight();
+
+        auto blocked = [&](int cell) {
+            for (int cross = crossFirst; cross <= crossLast; ++cross) {
+                const sf::Vector2i tile = horizontal ? sf::Vector2i(cell, cross) : sf::Vector2i(cross, cell);
+                if (tilemap.getTileFlags(tile.x, tile.y) & mask) {
+                    hitTile = tile;
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        if (delta > 0.f) {
+            const int from = std::max(lastCell(pos + size, tileSize) + 1, 0);
+            const int to = std::min(lastCell(pos + size + delta, tileSize), mapCells - 1);
+            for (int cell = from; cell <= to; ++cell) {
+                if (blocked(cell)) {
+                    pos = static_cast<float>(cell * tileSize) - size;
+                    return -1;
+                }
+            }
+        }
+        else {
+            const int from = std::min(firstCell(pos, tileSize) - 1, mapCells - 1);
+            const int to = std::max(firstCell(pos + delta, tileSize), 0);
+            for (int cell = from; cell >= to; --cell) {
+                if (blocked(cell)) {
+                    pos = static_cast<float>((cell + 1) * tileSize);
+                    return 1;
+                }
+            }
+        }
+        pos += delta;
+        return 0;
+    }
+};
@@ -8,8 +8,17 @@
 #include <array>
 #include <cmath>
 #include <cctype>
-#include <iostream>
 #include <optional>
+#include <limits>
+#include <sstream>
+#include <cstdint>
+#include <iterator>
+#include "AssetLoader.h"
+#include "TextureAtlas.h"
+#include "MovingPlatforms.h"
+#include "FrameArena.h"
+#include "Metrics.h"
+#include "Logger.h"
 
 
 class Tilemap {
@@ -30,12 +39,129 @@ public:
     };
 
     struct PowerupVisual {
-        sf::Texture texture;
+        sf::Texture ownedTexture;
+        TextureMetric ownedTextureMetric;
+        const sf::Texture* texture = nullptr; // ownedTexture or an atlas page
+        sf::IntRect rect;
+        sf::Vector2f origin;
         bool loaded = false;
         sf::Vector2i size{ 0, 0 };
         float scaleX = 1.f;
         float scaleY = 1.f;
     };
+
+    // Purely visual tile grid drawn behind or in front of the collision layer.
+    // parallax scales how far it scrolls with the camera (1 = with the level).
+    struct TileLayer {
+        std::vector<std::vector<int>> tiles;
+        sf::Vector2f parallax{ 1.f, 1.f };
+        bool foreground = false;
+    };
+
+    // Cached quads for one tile grid, plus which of its cells animate. A
+    // chunk holds quads only for cells that have been drawn, so memory
+    // follows the number of tiles rather than the level's area.
+    struct LayerGeometry {
+        static constexpr std::uint16_t noQuad = 0xFFFF;
+        std::vector<sf::VertexArray> chunks;
+        std::vector<std::vector<std::uint16_t>> chunkQuads; // per cell, its quad in the chunk or noQuad
+        std::vector<int> chunkTileCounts; // non-empty tiles per chunk
+        int columns = 0;
+        int rows = 0;
+        std::vector<std::vector<sf::Vector2i>> animatedCells; // per animation
+        int invalidTileId = 0; // first id found beyond the tileset grid, if any
+    };
+
+    // Parsed contents of a level file. Building one touches no GPU state, so
+    // it can be produced on a loader thread and applied later.
+    struct LevelData {
+        std::vector<std::vector<int>> tiles;
+        std::vector<sf::Vector2i> spawnTiles;
+        std::vector<sf::Vector2i> enemySpawnTiles;
+        std::vector<sf::Vector2i> goalTiles;
+        std::vector<sf::Vector2f> collectibles;
+        std::vector<PowerupPickup> powerups;
+        std::vector<TileLayer> decorLayers;
+        std::vector<MovingPlatforms::Spawn> platformSpawns;
+        // Filled by prepareGeometry(): the collision layer, then one per
+        // decoration layer. Rebuilt on apply if the tileset changed since.
+        std::vector<LayerGeometry> geometry;
+        std::uint64_t geometryVersion = 0;
+    };
+
+    // Result of a grid query. distance is measured along the ray in pixels;
+    // normal is the face that was entered, (0,0) if the query started inside.
+    struct TileHit {
+        bool hit = false;
+        sf::Vector2i tile{ 0, 0 };
+        float distance = 0.f;
+        sf::Vector2f point;
+        sf::Vector2i normal{ 0, 0 };
+    };
+    // Behaviour bits per tile id; collision paths test them with one lookup.
+    struct TileFlag {
+        static constexpr std::uint8_t Solid = 1 << 0;
+        static constexpr std::uint8_t OneWay = 1 << 1; // blocks only bodies landing from above
+        static constexpr std::uint8_t Hazard = 1 << 2;
+        static constexpr std::uint8_t Breakable = 1 << 3; // bricks: projectiles and powered head bumps
+    };
+
+    struct TileProperties {
+        std::uint8_t flags = TileFlag::Solid;
+        float friction = 1.f; // scales ground acceleration and braking
+        int bumpedId = 0;     // question blocks: tile left behind after a head bump
+    };
+
+    enum class TileBump {
+        None,
+        Bumped,
+        Broken
+    };
+
+    // One entry per setTile call since the level was applied, so a level
+    // reset only touches the cells that actually changed.
+    struct TileEdit {
+        int x;
+        int y;
+        int previousId;
+    };
+
+    // Tiles are drawn from fixed-size chunks of cached quads; a tile change
+    // rewrites only that tile's six vertices.
+    static constexpr int chunkTiles = 16;
+
+    static constexpr int maxTileIds = 64;
+    using TilePropertyTable = std::array<TileProperties, maxTileIds>;
+
+    // Frames are tile ids shown in turn by every cell holding tileId, all on
+    // one shared clock.
+    struct TileAnimation {
+        int tileId = 0;
+        std::vector<int> frames;
+        float frameDuration = 0.15f;
+    };
+
+    // Everything loaded from a tileset's .tiles file.
+    struct TileDefinitions {
+        TilePropertyTable properties = defaultTileProperties();
+        std::vector<TileAnimation> animations;
+    };
+
+    // Everything quad generation reads from the tileset, kept as a value so
+    // a copy can build a prepared level's geometry on the loader thread.
+    struct TileLayout {
+        int tileSize = 32;
+        int sourceWidth = 32;
+        int sourceHeight = 32;
+        sf::Vector2i origin{ 0, 0 };
+        int columns = 1;
+        int rows = 1;
+        bool loaded = false;
+        std::array<int, maxTileIds> animationForId{};
+        std::vector<int> displayedIds; // per animation, the tile id shown right now
+        std::uint64_t version = 0;     // bumped when the tileset or animations change
+    };
+
     int tileSize = 32;
     int tileSourceWidth = 32;
     int tileSourceHeight = 32;
@@ -51,12 +177,20 @@ public:
     std::vector<sf::Vector2f> collectibles;
     std::vector<bool> collectibleCollected;
     std::vector<PowerupPickup> powerups;
+    std::vector<TileLayer> decorLayers; // never consulted for collision
+    MovingPlatforms platforms;
+    int platformTileId = 3;          // tile drawn along each platform
+    int platformWidthTiles = 3;
+    float platformSpeed = 60.f;
    
 
 
     sf::Texture tilesetTexture;
-    sf::Sprite tileSprite;
+    TextureMetric tilesetTextureMetric;
+    const sf::Texture* tileTexture = nullptr; // tilesetTexture or an atlas page
+    std::vector<TileEdit> tileEdits;
     sf::Texture powerupTexture;
+    TextureMetric powerupTextureMetric;
     sf::Sprite powerupSprite;
     bool powerupTextureLoaded = false;
     int powerupTextureColumns = 1;
@@ -69,7 +203,11 @@ public:
     float powerupBaseScaleX = 1.f;
     float powerupBaseScaleY = 1.f;
     bool warnedInvalidTileIndex = false;
+    bool tilesetLoaded = false;
+    sf::Vector2i tilesetOrigin{ 0, 0 }; // top-left of the tileset inside its texture
     std::array<PowerupVisual, 6> powerupVisuals;
+    TilePropertyTable tileProperties = defaultTileProperties();
+    std::vector<TileAnimation> tileAnimations;
     Tilemap() = default;
 
 
@@ -79,6 +217,25 @@ public:
 
     // Load tileset texture
     void loadTileset(const std::string& path, int tileW, int tileH) {
+        if (tileW <= 0 || tileH <= 0) {
+            throw std::runtime_error("Tileset tile size must be posistive");
+        }
+        sf::Image image;
+        if (!image.loadFromFile(path)) {
+            throw std::runtime_error("Failed to load tileset");
+        }
+        applyTilesetImage(image, path, tileW, tileH);
+        applyTileDefinitions(parseTileDefinitions(tilePropertiesPathFor(path)));
+        powerupTextureLoaded = loadPowerupTexture("Assets/powerups.png", 3, 2);
+        if (!powerupTextureLoaded) {
+            powerupTextureLoaded = loadPowerupTexture("Assets/powerup.png", 1, 1);
+
+        }
+        loadIndividualPowerups();
+    }
+
+    // Uploads an already decoded tileset. Must run on the thread owning the GL context.
+    void applyTilesetImage(const sf::Image& image, const std::string& path, int tileW, int tileH) {
         tileSourceWidth = tileW;
         tileSourceHeight = tileH;
         if (tileSourceWidth <= 0 || tileSourceHeight <= 0) {
@@ -86,56 +243,186 @@ public:
         }
 
 
-        if (!tilesetTexture.loadFromFile(path)) {
+        if (!tilesetTexture.loadFromImage(image)) {
             throw std::runtime_error("Failed to load tileset");
         }
+        tilesetTextureMetric.set(tilesetTexture);
 
         const auto textureSize = tilesetTexture.getSize();
         const unsigned int remainderX = textureSize.x % static_cast<unsigned int>(tileSourceWidth);
         const unsigned int remainderY = textureSize.y % static_cast<unsigned int>(tileSourceHeight);
         if (remainderX != 0 || remainderY != 0) {
-            std::cerr << "Warning: tileset size " << textureSize.x << "x" << textureSize.y
-                << " is not divisible by tile size " << tileSourceWidth << "x" << tileSourceHeight << ".\n";
-        }
-
-        tileSprite.setTexture(tilesetTexture);
-        tilesetColumns = std::max(1, static_cast<int>(tilesetTexture.getSize().x) / tileSourceWidth);
-        tilesetRows = std::max(1, static_cast<int>(tilesetTexture.getSize().y) / tileSourceHeight);
-        tileScaleX = static_cast<float>(tileSize) / static_cast<float>(tileSourceWidth);
-        tileScaleY = static_cast<float>(tileSize) / static_cast<float>(tileSourceHeight);
-        tileSprite.setScale(tileScaleX, tileScaleY);
-        std::cout << "Loaded tileset " << path << " (" << textureSize.x << "x" << textureSize.y
-            << "), tile source " << tileSourceWidth << "x" << tileSourceHeight
-            << ", grid " << tilesetColumns << "x" << tilesetRows << ".\n";
-        powerupTextureLoaded = loadPowerupTexture("Assets/powerups.png", 3, 2);
-        if (!powerupTextureLoaded) {
-            powerupTextureLoaded = loadPowerupTexture("Assets/powerup.png", 1, 1);
+            Log::warning(LogCategory::Assets, "tileset size %ux%u is not divisible by tile size %dx%d",
+                textureSize.x, textureSize.y, tileSourceWidth, tileSourceHeight);
+        }
+
+        configureTileset(tilesetTexture,
+            sf::IntRect(0, 0, static_cast<int>(textureSize.x), static_cast<int>(textureSize.y)));
+        Log::info(LogCategory::Assets, "Loaded tileset %s (%ux%u), tile source %dx%d, grid %dx%d.",
+            path.c_str(), textureSize.x, textureSize.y, tileSourceWidth, tileSourceHeight,
+            tilesetColumns, tilesetRows);
+    }
 
+    // Points tiles and powerup icons at regions of a shared atlas so the level
+    // draws without switching textures. Missing entries keep their current source.
+    void useAtlas(const TextureAtlas& atlas, const std::string& tilesetKey, int tileW, int tileH) {
+        if (const TextureAtlas::Region* region = atlas.find(tilesetKey)) {
+            if (tileW > 0 && tileH > 0) {
+                tileSourceWidth = tileW;
+                tileSourceHeight = tileH;
+                configureTileset(*region->texture, region->rect);
+            }
+        }
+        for (int i = 0; i < powerupTypeCount; ++i) {
+            const PowerupType type = static_cast<PowerupType>(i);
+            for (const auto& path : getPowerupTextureCandidates(type)) {
+                const TextureAtlas::Region* region = atlas.find(path);
+                if (!region) {
+                    continue;
+                }
+                configurePowerupVisual(powerupVisuals[powerupIndex(type)], *region->texture,
+                    region->rect, region->sourceSize, region->trimOffset);
+                break;
+            }
+        }
+    }
+
+    static std::vector<std::string> getPowerupTextureCandidates(PowerupType type) {
+        const std::string filename = getPowerupFilename(type);
+        const std::string legacyName = getPowerupLegacyBasename(type);
+        return {
+            "Assets/powerups/" + filename,
+            "Assets/" + filename,
+            "Assets/powerup_" + filename,
+            "Assets/powerup_" + legacyName + ".png",
+            "Assets/" + legacyName + ".png"
+        };
+    }
+
+    // The combined sheet is only drawn for types without their own image.
+    void requestPowerupSheet(AssetLoader& loader) {
+        loader.requestImage({ "Assets/powerups.png", "Assets/powerup.png" },
+            [this](const sf::Image* image, const std::string& path) {
+                if (!image) {
+                    return;
+                }
+                const bool isSheet = path == "Assets/powerups.png";
+                powerupTextureLoaded = applyPowerupSheetImage(*image, isSheet ? 3 : 1, isSheet ? 2 : 1);
+            });
+    }
+
+    // Decodes every powerup image on the loader thread; textures are created
+    // as the decoded images are handed back.
+    void requestPowerupTextures(AssetLoader& loader) {
+        requestPowerupSheet(loader);
+        for (int i = 0; i < powerupTypeCount; ++i) {
+            const PowerupType type = static_cast<PowerupType>(i);
+            loader.requestImage(getPowerupTextureCandidates(type),
+                [this, type](const sf::Image* image, const std::string&) {
+                    if (image) {
+                        applyPowerupImage(type, *image);
+                    }
+                });
         }
-        loadIndividualPowerups();
     }
 
     // TEMP level generator (safe)
     void loadFromFile(const std::string& path) {
+        applyLevel(parseLevelFile(path, tileSize));
+    }
+
+    void applyLevel(LevelData&& level) {
+        if (level.tiles.empty()) {
+            return;
+
+        }
+        tiles = std::move(level.tiles);
+        spawnTiles = std::move(level.spawnTiles);
+        enemySpawnTiles = std::move(level.enemySpawnTiles);
+        goalTiles = std::move(level.goalTiles);
+        collectibles = std::move(level.collectibles);
+        collectibleCollected.assign(collectibles.size(), false);
+        powerups = std::move(level.powerups);
+        decorLayers = std::move(level.decorLayers);
+        platforms.load(level.platformSpawns,
+            sf::Vector2f(static_cast<float>(platformWidthTiles * tileSize), static_cast<float>(tileSize) / 2.f),
+            platformSpeed);
+        tileEdits.clear();
+        if (level.geometryVersion == layout.version && level.geometry.size() == decorLayers.size() + 1) {
+            collisionGeometry = std::move(level.geometry.front());
+            decorGeometry.assign(std::make_move_iterator(level.geometry.begin() + 1),
+                std::make_move_iterator(level.geometry.end()));
+            // Animations kept running while the level was prepared.
+            for (std::size_t i = 0; i < tileAnimations.size(); ++i) {
+                writeAnimatedCells(i);
+            }
+            reportInvalidTiles();
+        }
+        else {
+            rebuildTileGeometry();
+        }
+    }
+
+    // Builds the quads applyLevel() would, so applying becomes a move. Safe
+    // off the main thread given a layout copied there from getTileLayout().
+    static void prepareGeometry(LevelData& level, const TileLayout& tileLayout) {
+        level.geometry.resize(level.decorLayers.size() + 1);
+        buildLayerGeometry(level.geometry.front(), level.tiles, tileLayout);
+        for (std::size_t i = 0; i < level.decorLayers.size(); ++i) {
+            buildLayerGeometry(level.geometry[i + 1], level.decorLayers[i].tiles, tileLayout);
+        }
+        level.geometryVersion = tileLayout.version;
+    }
+
+    const TileLayout& getTileLayout() const {
+        return layout;
+    }
+
+    // Pure parse with no side effects on the tilemap; safe off the main thread.
+    // Rows before any section header form the collision layer. A line such as
+    // "[background 0.5]" or "[foreground 1.2 1]" starts a decoration layer with
+    // that x (and optional y) parallax; "[collision]" switches back.
+    static LevelData parseLevelFile(const std::string& path, int tileSize) {
+        LevelData level;
+        const float platformTravel = static_cast<float>(4 * tileSize);
         std::ifstream file(path);
         if (!file.is_open()) {
             throw std::runtime_error("Failed to load level file: " + path);
 
         }
         std::vector<std::string> lines;
+        std::vector<std::vector<std::string>> layerLines;
+        std::vector<std::string>* currentLines = &lines;
         std::string line;
         while (std::getline(file, line)) {
             if (!line.empty() && line.back() == '\r') {
                 line.pop_back();
 
             }
+            if (!line.empty() && line.front() == '[') {
+                currentLines = parseLayerHeader(line, path, level, layerLines, lines);
+                continue;
+            }
             if (!line.empty()) {
-                lines.push_back(line);
+                currentLines->push_back(line);
 
             }
         }
+        for (std::size_t i = 0; i < layerLines.size(); ++i) {
+            std::size_t layerWidth = 0;
+            for (const auto& row : layerLines[i]) {
+                layerWidth = std::max(layerWidth, row.size());
+            }
+            auto& grid = level.decorLayers[i].tiles;
+            grid.assign(layerLines[i].size(), std::vector<int>(layerWidth, 0));
+            for (std::size_t y = 0; y < layerLines[i].size(); ++y) {
+                for (std::size_t x = 0; x < layerLines[i][y].size(); ++x) {
+                    grid[y][x] = tileIndexFromChar(layerLines[i][y][x]);
+                }
+            }
+        }
         if (lines.empty()) {
-            return;
+            return level;
 
         }
         std::size_t maxWidth = 0;
@@ -144,17 +431,13 @@ public:
 
 
         }
+        auto& tiles = level.tiles;
+        auto& spawnTiles = level.spawnTiles;
+        auto& enemySpawnTiles = level.enemySpawnTiles;
+        auto& goalTiles = level.goalTiles;
+        auto& collectibles = level.collectibles;
+        auto& powerups = level.powerups;
         tiles.assign(lines.size(), std::vector<int>(static_cast<int>(maxWidth), 0));
-        spawnTiles.clear();
-        enemySpawnTiles.clear();
-        goalTiles.clear();
-        collectibles.clear();
-        collectibleCollected.clear();
-        powerups.clear();
-       
-
-
-
 
         for (std::size_t y = 0; y < lines.size(); ++y) {
             for (std::size_t x = 0; x < maxWidth && x < lines[y].size(); ++x) {
@@ -176,12 +459,23 @@ public:
                 case 'g':
                     goalTiles.push_back(sf::Vector2i(static_cast<int>(x), static_cast<int>(y)));
                     break;
+                case 'P':
+                case 'p':
+                    level.platformSpawns.push_back({
+                        sf::Vector2f(static_cast<float>(x * tileSize), static_cast<float>(y * tileSize)),
+                        sf::Vector2f(platformTravel, 0.f) });
+                    break;
+                case 'V':
+                case 'v':
+                    level.platformSpawns.push_back({
+                        sf::Vector2f(static_cast<float>(x * tileSize), static_cast<float>(y * tileSize)),
+                        sf::Vector2f(0.f, -platformTravel) });
+                    break;
                 case 'C':
                 case 'c': {
                     const float worldX = static_cast<float>(x * tileSize + tileSize / 2);
                     const float worldY = static_cast<float>(y * tileSize + tileSize / 2);
                     collectibles.emplace_back(worldX, worldY);
-                    collectibleCollected.push_back(false);
                     break;
                 }
                 case 'M':
@@ -235,51 +529,185 @@ public:
                 
             }
         }
-
-        
-
-        
+        return level;
     }
 
-    // No update needed yet, but included for engine consistency
-    void update(float dt) {
-        powerupAnimTime += dt;
-
-        
+    // Properties live next to the tileset: Assets/tileset.png -> Assets/tileset.tiles
+    static std::string tilePropertiesPathFor(const std::string& tilesetPath) {
+        const std::size_t dot = tilesetPath.find_last_of('.');
+        return (dot == std::string::npos ? tilesetPath : tilesetPath.substr(0, dot)) + ".tiles";
     }
 
-    void render(sf::RenderTarget& target) {
-        for (int y = 0; y < static_cast<int>(tiles.size()); ++y) {
-            for (int x = 0; x < static_cast<int>(tiles[y].size()); ++x) {
+    static TilePropertyTable defaultTileProperties() {
+        TilePropertyTable table{};
+        table[0].flags = 0;
+        return table;
+    }
 
-                if (tiles[y][x] <= 0)
+    // One line per tile: the tile's level character (or numeric id), then
+    // any of solid, oneway, hazard, breakable, bumped=<char>,
+    // friction=<scale>, anim=<chars> and frametime=<seconds>. Listed flags
+    // replace the default "solid". A missing file leaves every tile solid.
+    static TileDefinitions parseTileDefinitions(const std::string& path) {
+        TileDefinitions definitions;
+        TilePropertyTable& table = definitions.properties;
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return definitions;
+        }
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line)) {
+            ++lineNumber;
+            const std::size_t comment = line.find('#');
+            if (comment != std::string::npos) {
+                line.erase(comment);
+            }
+            std::istringstream tokens(line);
+            std::string idToken;
+            if (!(tokens >> idToken)) {
+                continue;
+            }
+            int id = 0;
+            if (idToken.size() == 1) {
+                id = tileIndexFromChar(idToken[0]);
+            }
+            else {
+                try {
+                    id = std::stoi(idToken);
+                }
+                catch (const std::exception&) {
+                    id = 0;
+                }
+            }
+            if (id <= 0 || id >= maxTileIds) {
+                Log::warning(LogCategory::Assets, "%s:%d: invalid tile id '%s'", path.c_str(), lineNumber, idToken.c_str());
+                continue;
+            }
+            TileProperties properties;
+            TileAnimation animation;
+            animation.tileId = id;
+            bool hasFlags = false;
+            std::string token;
+            while (tokens >> token) {
+                std::uint8_t flag = 0;
+                if (token == "solid") {
+                    flag = TileFlag::Solid;
+                }
+                else if (token == "oneway") {
+                    flag = TileFlag::OneWay;
+                }
+                else if (token == "hazard") {
+                    flag = TileFlag::Hazard;
+                }
+                else if (token == "breakable") {
+                    flag = TileFlag::Breakable;
+                }
+                else if (token.rfind("bumped=", 0) == 0 && token.size() == 8) {
+                    properties.bumpedId = tileIndexFromChar(token[7]);
+                    continue;
+                }
+                else if (token.rfind("anim=", 0) == 0) {
+                    animation.frames.clear();
+                    for (char c : token.substr(5)) {
+                        const int frame = tileIndexFromChar(c);
+                        if (frame > 0) {
+                            animation.frames.push_back(frame);
+                        }
+                    }
                     continue;
-
-                // Draw ONLY ONE tile region
-                const int maxIndex = tilesetColumns * tilesetRows - 1;
-                const int rawIndex = tiles[y][x] - 1;
-                if (!warnedInvalidTileIndex && rawIndex > maxIndex) {
-                    warnedInvalidTileIndex = true;
-                    std::cerr << "Warning: level references tile index " << tiles[y][x]
-                        << " but tileset grid supports up to " << (maxIndex + 1)
-                        << " tiles.\n";
                 }
-                const int safeIndex = std::clamp(rawIndex, 0, maxIndex);
-                const int tileX = (safeIndex % tilesetColumns) * tileSourceWidth;
-                const int tileY = (safeIndex / tilesetColumns) * tileSourceHeight;
-                tileSprite.setTextureRect(
-                    sf::IntRect(tileX, tileY, tileSourceWidth, tileSourceHeight)
-                );
+                else if (token.rfind("frametime=", 0) == 0) {
+                    try {
+                        animation.frameDuration = std::max(0.01f, std::stof(token.substr(10)));
+                    }
+                    catch (const std::exception&) {
+                        Log::warning(LogCategory::Assets, "%s:%d: bad frame time '%s'", path.c_str(), lineNumber, token.c_str());
+                    }
+                    continue;
+                }
+                else if (token.rfind("friction=", 0) == 0) {
+                    try {
+                        properties.friction = std::max(0.f, std::stof(token.substr(9)));
+                    }
+                    catch (const std::exception&) {
+                        Log::warning(LogCategory::Assets, "%s:%d: bad friction '%s'", path.c_str(), lineNumber, token.c_str());
+                    }
+                    continue;
+                }
+                else {
+                    Log::warning(LogCategory::Assets, "%s:%d: unknown tile property '%s'", path.c_str(), lineNumber, token.c_str());
+                    continue;
+                }
+                if (!hasFlags) {
+                    properties.flags = 0;
+                    hasFlags = true;
+                }
+                properties.flags |= flag;
+            }
+            table[id] = properties;
+            if (animation.frames.size() > 1) {
+                definitions.animations.push_back(std::move(animation));
+            }
+        }
+        return definitions;
+    }
 
-                tileSprite.setPosition(
-                    static_cast<float>(x * tileSize),
-                    static_cast<float>(y * tileSize)
-                );
+    void applyTileDefinitions(TileDefinitions&& definitions) {
+        tileProperties = definitions.properties;
+        tileAnimations = std::move(definitions.animations);
+        animationForId.fill(-1);
+        for (std::size_t i = 0; i < tileAnimations.size(); ++i) {
+            animationForId[tileAnimations[i].tileId] = static_cast<int>(i);
+        }
+        animationFrame.assign(tileAnimations.size(), 0);
+        animationElapsed.assign(tileAnimations.size(), 0.f);
+        refreshLayout();
+        rebuildTileGeometry();
+    }
 
-                target.draw(tileSprite);
+    void update(float dt) {
+        powerupAnimTime += dt;
+        // Before any entity update, so riders follow this tick's motion.
+        platforms.update(dt);
+        // Only cells of an animation whose frame just changed get new
+        // texture coordinates; positions and other tiles are untouched.
+        for (std::size_t i = 0; i < tileAnimations.size(); ++i) {
+            const TileAnimation& animation = tileAnimations[i];
+            // Time into the current frame only, so it stays small however
+            // long the game runs.
+            animationElapsed[i] += dt;
+            if (animationElapsed[i] < animation.frameDuration) {
+                continue;
             }
+            const float steps = std::floor(animationElapsed[i] / animation.frameDuration);
+            animationElapsed[i] -= steps * animation.frameDuration;
+            const std::size_t frame = (animationFrame[i] + static_cast<std::size_t>(steps)) % animation.frames.size();
+            if (frame == animationFrame[i]) {
+                continue;
+            }
+            animationFrame[i] = frame;
+            layout.displayedIds[i] = animation.frames[frame];
+            writeAnimatedCells(i);
         }
-        sf::CircleShape coinShape(static_cast<float>(tileSize) * 0.35f);
+    }
+
+    // Decoration layers behind the collision layer; call before render().
+    void renderBackground(sf::RenderTarget& target) {
+        renderDecorLayers(target, false);
+    }
+
+    // Decoration layers drawn over entities; call after the scene.
+    void renderForeground(sf::RenderTarget& target) {
+        renderDecorLayers(target, true);
+    }
+
+    void render(sf::RenderTarget& target) {
+        if (tilesetLoaded && tileTexture) {
+            drawVisibleChunks(target, collisionGeometry);
+            drawPlatforms(target);
+        }
+        coinShape.setRadius(static_cast<float>(tileSize) * 0.35f);
         coinShape.setFillColor(sf::Color(255, 215, 0));
         coinShape.setOrigin(coinShape.getRadius(), coinShape.getRadius());
 
@@ -289,6 +717,7 @@ public:
 
             coinShape.setPosition(collectibles[i]);
             target.draw(coinShape);
+            Metrics::count(MetricCounter::DrawCalls);
         }
         if (powerupTextureLoaded || hasAnyIndividualPowerups()) {
             for (std::size_t i = 0; i < powerups.size(); ++i) {
@@ -302,9 +731,9 @@ public:
                 const sf::Uint8 alpha = static_cast<sf::Uint8>(200 + 55 * glow);
                 const PowerupVisual* visual = getPowerupVisual(powerups[i].type);
                 if (visual && visual->loaded) {
-                    powerupSprite.setTexture(visual->texture, true);
-                    powerupSprite.setTextureRect(sf::IntRect(0, 0, visual->size.x, visual->size.y));
-                    powerupSprite.setOrigin(static_cast<float>(visual->size.x) / 2.f, static_cast<float>(visual->size.y) / 2.f);
+                    powerupSprite.setTexture(*visual->texture);
+                    powerupSprite.setTextureRect(visual->rect);
+                    powerupSprite.setOrigin(visual->origin);
                     powerupSprite.setScale(visual->scaleX * pulse, visual->scaleY * pulse);
                     powerupSprite.setColor(sf::Color(255, 255, 255, alpha));
                 }
@@ -325,10 +754,11 @@ public:
 
 
                 target.draw(powerupSprite);
+                Metrics::count(MetricCounter::DrawCalls);
             }
         }
         else {
-            sf::RectangleShape powerupShape(sf::Vector2f(static_cast<float>(tileSize) * 0.8f, static_cast<float>(tileSize) * 0.8f));
+            powerupShape.setSize(sf::Vector2f(static_cast<float>(tileSize) * 0.8f, static_cast<float>(tileSize) * 0.8f));
             powerupShape.setOrigin(powerupShape.getSize() / 2.f);
             for (std::size_t i = 0; i < powerups.size(); ++i) {
                 if (powerups[i].collected)
@@ -338,6 +768,7 @@ public:
                 powerupShape.setFillColor(getPowerupTint(powerups[i].type, 255));
                 powerupShape.setPosition(powerups[i].position);
                 target.draw(powerupShape);
+                Metrics::count(MetricCounter::DrawCalls);
             }
         
 
@@ -345,20 +776,194 @@ public:
 
 
         // Render goals as highlighted tiles
-        sf::RectangleShape goalShape(sf::Vector2f(static_cast<float>(tileSize), static_cast<float>(tileSize)));
+        goalShape.setSize(sf::Vector2f(static_cast<float>(tileSize), static_cast<float>(tileSize)));
         goalShape.setFillColor(sf::Color(100, 200, 255, 180));
         for (const auto& tile : goalTiles) {
             goalShape.setPosition(static_cast<float>(tile.x * tileSize), static_cast<float>(tile.y * tileSize));
             target.draw(goalShape);
+            Metrics::count(MetricCounter::DrawCalls);
         }
 
 
     }
 
+    std::uint8_t getTileFlags(int x, int y) const {
+        if (y < 0 || y >= static_cast<int>(tiles.size())) return 0;
+        if (x < 0 || x >= static_cast<int>(tiles[y].size())) return 0;
+        const int id = tiles[y][x];
+        if (id <= 0) return 0;
+        return id < maxTileIds ? tileProperties[id].flags : TileFlag::Solid;
+    }
+
+    const TileProperties& getTileProperties(int x, int y) const {
+        static const TileProperties empty{ 0, 1.f };
+        static const TileProperties unlisted{};
+        if (y < 0 || y >= static_cast<int>(tiles.size())) return empty;
+        if (x < 0 || x >= static_cast<int>(tiles[y].size())) return empty;
+        const int id = tiles[y][x];
+        if (id <= 0) return empty;
+        return id < maxTileIds ? tileProperties[id] : unlisted;
+    }
+
     bool isSolid(int x, int y) const {
+        return (getTileFlags(x, y) & TileFlag::Solid) != 0;
+    }
+
+    int getTile(int x, int y) const {
+        if (y < 0 || y >= static_cast<int>(tiles.size())) return 0;
+        if (x < 0 || x >= static_cast<int>(tiles[y].size())) return 0;
+        return tiles[y][x];
+    }
+
+    // Changes one cell: collision sees it immediately and only that tile's
+    // cached quad is rewritten. The change is logged for resetTileEdits().
+    bool setTile(int x, int y, int id) {
         if (y < 0 || y >= static_cast<int>(tiles.size())) return false;
         if (x < 0 || x >= static_cast<int>(tiles[y].size())) return false;
-        return tiles[y][x] > 0;
+        if (tiles[y][x] == id) return false;
+        tileEdits.push_back({ x, y, tiles[y][x] });
+        assignTile(x, y, id);
+        return true;
+    }
+
+    bool breakTile(int x, int y) {
+        if (!(getTileFlags(x, y) & TileFlag::Breakable)) {
+            return false;
+        }
+        return setTile(x, y, 0);
+    }
+
+    // Head bump from below. Question blocks turn into their bumped tile;
+    // bricks only break when canBreak is set.
+    TileBump bumpTile(int x, int y, bool canBreak) {
+        const TileProperties& properties = getTileProperties(x, y);
+        if (properties.bumpedId > 0) {
+            return setTile(x, y, properties.bumpedId) ? TileBump::Bumped : TileBump::None;
+        }
+        if (canBreak && breakTile(x, y)) {
+            return TileBump::Broken;
+        }
+        return TileBump::None;
+    }
+
+    // Undoes every edit since the level was applied, newest first.
+    void resetTileEdits() {
+        for (auto it = tileEdits.rbegin(); it != tileEdits.rend(); ++it) {
+            assignTile(it->x, it->y, it->previousId);
+        }
+        tileEdits.clear();
+    }
+
+    sf::Vector2i worldToTile(sf::Vector2f point) const {
+        return sf::Vector2i(
+            static_cast<int>(std::floor(point.x / tileSize)),
+            static_cast<int>(std::floor(point.y / tileSize)));
+    }
+
+    bool isSolidAt(sf::Vector2f point) const {
+        const sf::Vector2i tile = worldToTile(point);
+        return isSolid(tile.x, tile.y);
+    }
+
+    // Walks the grid cell by cell (DDA) and stops at the first solid tile or
+    // once the ray leaves the map for good. direction need not be normalized.
+    TileHit raycast(sf::Vector2f origin, sf::Vector2f direction, float maxDistance,
+        std::uint8_t mask = TileFlag::Solid) const {
+        TileHit result;
+        Metrics::count(MetricCounter::CollisionQueries);
+        const float length = std::sqrt(direction.x * direction.x + direction.y * direction.y);
+        if (tileSize <= 0 || length <= 0.f || maxDistance < 0.f) {
+            return result;
+        }
+        const sf::Vector2f dir(direction.x / length, direction.y / length);
+        sf::Vector2i cell = worldToTile(origin);
+        if (getTileFlags(cell.x, cell.y) & mask) {
+            result.hit = true;
+            result.tile = cell;
+            result.point = origin;
+            return result;
+        }
+
+        const float infinity = std::numeric_limits<float>::infinity();
+        const int stepX = dir.x > 0.f ? 1 : (dir.x < 0.f ? -1 : 0);
+        const int stepY = dir.y > 0.f ? 1 : (dir.y < 0.f ? -1 : 0);
+        const float size = static_cast<float>(tileSize);
+        float tMaxX = stepX == 0 ? infinity
+            : ((stepX > 0 ? cell.x + 1 : cell.x) * size - origin.x) / dir.x;
+        float tMaxY = stepY == 0 ? infinity
+            : ((stepY > 0 ? cell.y + 1 : cell.y) * size - origin.y) / dir.y;
+        const float tDeltaX = stepX == 0 ? infinity : size / std::abs(dir.x);
+        const float tDeltaY = stepY == 0 ? infinity : size / std::abs(dir.y);
+        const int width = getWidth();
+        const int height = getHeight();
+
+        for (;;) {
+            float t = 0.f;
+            sf::Vector2i normal;
+            if (tMaxX < tMaxY) {
+                t = tMaxX;
+                cell.x += stepX;
+                tMaxX += tDeltaX;
+                normal = sf::Vector2i(-stepX, 0);
+            }
+            else {
+                t = tMaxY;
+                cell.y += stepY;
+                tMaxY += tDeltaY;
+                normal = sf::Vector2i(0, -stepY);
+            }
+            if (t > maxDistance) {
+                return result;
+            }
+            const bool leftForGood = (cell.x < 0 && stepX <= 0) || (cell.x >= width && stepX >= 0)
+                || (cell.y < 0 && stepY <= 0) || (cell.y >= height && stepY >= 0);
+            if (leftForGood) {
+                return result;
+            }
+            if (getTileFlags(cell.x, cell.y) & mask) {
+                result.hit = true;
+                result.tile = cell;
+                result.distance = t;
+                result.point = sf::Vector2f(origin.x + dir.x * t, origin.y + dir.y * t);
+                result.normal = normal;
+                return result;
+            }
+        }
+    }
+
+    TileHit segmentCast(sf::Vector2f from, sf::Vector2f to, std::uint8_t mask = TileFlag::Solid) const {
+        const sf::Vector2f delta = to - from;
+        return raycast(from, delta, std::sqrt(delta.x * delta.x + delta.y * delta.y), mask);
+    }
+
+    // First tile (row-major) matching mask touched by the box. Edges lying
+    // exactly on a tile boundary do not touch the neighbouring tile.
+    TileHit queryOverlap(const sf::FloatRect& box, std::uint8_t mask = TileFlag::Solid) const {
+        TileHit result;
+        Metrics::count(MetricCounter::CollisionQueries);
+        if (tileSize <= 0) {
+            return result;
+        }
+        const float epsilon = 0.001f;
+        const int firstX = std::max(0, static_cast<int>(std::floor((box.left + epsilon) / tileSize)));
+        const int lastX = std::min(getWidth() - 1, static_cast<int>(std::floor((box.left + box.width - epsilon) / tileSize)));
+        const int firstY = std::max(0, static_cast<int>(std::floor((box.top + epsilon) / tileSize)));
+        const int lastY = std::min(getHeight() - 1, static_cast<int>(std::floor((box.top + box.height - epsilon) / tileSize)));
+        for (int y = firstY; y <= lastY; ++y) {
+            for (int x = firstX; x <= lastX; ++x) {
+                if (getTileFlags(x, y) & mask) {
+                    result.hit = true;
+                    result.tile = sf::Vector2i(x, y);
+                    result.point = sf::Vector2f(static_cast<float>(x * tileSize), static_cast<float>(y * tileSize));
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+    bool overlapsSolid(const sf::FloatRect& box) const {
+        return queryOverlap(box).hit;
     }
 
     int getWidth() const {
@@ -388,8 +993,8 @@ public:
         const sf::Vector2i tile = spawnTiles.front();
         return sf::Vector2f(static_cast<float>(tile.x * tileSize), static_cast<float>(tile.y * tileSize));
     }
-    std::vector<sf::Vector2f> getEnemySpawnPoints() const {
-        std::vector<sf::Vector2f> points;
+    FrameVector<sf::Vector2f> getEnemySpawnPoints(FrameArena& arena) const {
+        FrameVector<sf::Vector2f> points(arena.allocator<sf::Vector2f>());
         points.reserve(enemySpawnTiles.size());
         for (const auto& tile : enemySpawnTiles) {
             points.emplace_back(static_cast<float>(tile.x * tileSize), static_cast<float>(tile.y * tileSize));
@@ -487,17 +1092,38 @@ public:
         }
 
         bool tryLoadPowerupTexture(PowerupType type, const std::string& path) {
+            sf::Image image;
+            if (!image.loadFromFile(path)) {
+                return false;
+            }
+            return applyPowerupImage(type, image);
+        }
+
+        bool applyPowerupImage(PowerupType type, const sf::Image& image) {
             PowerupVisual& visual = powerupVisuals[powerupIndex(type)];
-            if (!visual.texture.loadFromFile(path)) {
+            if (!visual.ownedTexture.loadFromImage(image)) {
                 return false;
             }
-            const auto textureSize = visual.texture.getSize();
-            visual.size = sf::Vector2i(
-                static_cast<int>(textureSize.x),
-                static_cast<int>(textureSize.y));
+            visual.ownedTextureMetric.set(visual.ownedTexture);
+            const auto textureSize = visual.ownedTexture.getSize();
+            const sf::Vector2i size(static_cast<int>(textureSize.x), static_cast<int>(textureSize.y));
+            return configurePowerupVisual(visual, visual.ownedTexture,
+                sf::IntRect(0, 0, size.x, size.y), size, sf::Vector2i(0, 0));
+        }
+
+        // Trimmed regions keep the untrimmed size for scale and origin so the
+        // icon lands exactly where the full image would have.
+        bool configurePowerupVisual(PowerupVisual& visual, const sf::Texture& texture,
+            const sf::IntRect& rect, sf::Vector2i sourceSize, sf::Vector2i trimOffset) {
+            visual.size = sourceSize;
             if (visual.size.x <= 0 || visual.size.y <= 0) {
                 return false;
             }
+            visual.texture = &texture;
+            visual.rect = rect;
+            visual.origin = sf::Vector2f(
+                static_cast<float>(sourceSize.x) / 2.f - static_cast<float>(trimOffset.x),
+                static_cast<float>(sourceSize.y) / 2.f - static_cast<float>(trimOffset.y));
             const float targetSize = static_cast<float>(tileSize) * 1.5f;
             visual.scaleX = targetSize / static_cast<float>(visual.size.x);
             visual.scaleY = targetSize / static_cast<float>(visual.size.y);
@@ -519,18 +1145,6 @@ public:
             return visual.loaded ? &visual : nullptr;
         }
 
-        static std::vector<std::string> getPowerupTextureCandidates(PowerupType type) {
-            const std::string filename = getPowerupFilename(type);
-            const std::string legacyName = getPowerupLegacyBasename(type);
-            return {
-                "Assets/powerups/" + filename,
-                "Assets/" + filename,
-                "Assets/powerup_" + filename,
-                "Assets/powerup_" + legacyName + ".png",
-                "Assets/" + legacyName + ".png"
-            };
-        }
-
         static std::string getPowerupBasename(PowerupType type) {
             switch (type) {
             case PowerupType::SuperMushroom:
@@ -578,9 +1192,18 @@ public:
         }
 
         bool loadPowerupTexture(const std::string& path, int columns, int rows) {
-            if (!powerupTexture.loadFromFile(path)) {
+            sf::Image image;
+            if (!image.loadFromFile(path)) {
+                return false;
+            }
+            return applyPowerupSheetImage(image, columns, rows);
+        }
+
+        bool applyPowerupSheetImage(const sf::Image& image, int columns, int rows) {
+            if (!powerupTexture.loadFromImage(image)) {
                 return false;
             }
+            powerupTextureMetric.set(powerupTexture);
             powerupTextureColumns = std::max(1, columns);
             powerupTextureRows = std::max(1, rows);
             const auto textureSize = powerupTexture.getSize();
@@ -654,6 +1277,323 @@ public:
                 return sf::Color(220, 80, 80, alpha);
             }
         }
+        void configureTileset(const sf::Texture& texture, const sf::IntRect& region) {
+            tileTexture = &texture;
+            tilesetOrigin = sf::Vector2i(region.left, region.top);
+            tilesetColumns = std::max(1, region.width / tileSourceWidth);
+            tilesetRows = std::max(1, region.height / tileSourceHeight);
+            tileScaleX = static_cast<float>(tileSize) / static_cast<float>(tileSourceWidth);
+            tileScaleY = static_cast<float>(tileSize) / static_cast<float>(tileSourceHeight);
+            tilesetLoaded = true;
+            refreshLayout();
+            rebuildTileGeometry();
+        }
+
+        TileLayout layout;
+        LayerGeometry collisionGeometry;
+        std::vector<LayerGeometry> decorGeometry; // parallel to decorLayers
+        std::array<int, maxTileIds> animationForId = makeAnimationLookup();
+        std::vector<std::size_t> animationFrame;
+        std::vector<float> animationElapsed; // seconds into animationFrame
+
+        static std::array<int, maxTileIds> makeAnimationLookup() {
+            std::array<int, maxTileIds> lookup;
+            lookup.fill(-1);
+            return lookup;
+        }
+
+        int animationIndexFor(int id) const {
+            return (id > 0 && id < maxTileIds) ? animationForId[id] : -1;
+        }
+
+        // Tile id currently drawn for id, following its animation if any.
+        int displayedTileId(int id) const {
+            const int animation = animationIndexFor(id);
+            if (animation < 0) {
+                return id;
+            }
+            return tileAnimations[animation].frames[animationFrame[animation]];
+        }
+
+        void assignTile(int x, int y, int id) {
+            const int previousAnimation = animationIndexFor(tiles[y][x]);
+            if (previousAnimation >= 0) {
+                auto& cells = collisionGeometry.animatedCells[previousAnimation];
+                const auto it = std::find(cells.begin(), cells.end(), sf::Vector2i(x, y));
+                if (it != cells.end()) {
+                    *it = cells.back();
+                    cells.pop_back();
+                }
+            }
+            tiles[y][x] = id;
+            const int animation = animationIndexFor(id);
+            if (animation >= 0) {
+                collisionGeometry.animatedCells[animation].push_back(sf::Vector2i(x, y));
+            }
+            writeTileVertices(collisionGeometry, tiles, x, y, layout);
+            reportInvalidTiles();
+        }
+
+        // Called whenever anything TileLayout mirrors changes, apart from
+        // the per-frame displayed ids that update() keeps current.
+        void refreshLayout() {
+            layout.tileSize = tileSize;
+            layout.sourceWidth = tileSourceWidth;
+            layout.sourceHeight = tileSourceHeight;
+            layout.origin = tilesetOrigin;
+            layout.columns = tilesetColumns;
+            layout.rows = tilesetRows;
+            layout.loaded = tilesetLoaded;
+            layout.animationForId = animationForId;
+            layout.displayedIds.resize(tileAnimations.size());
+            for (std::size_t i = 0; i < tileAnimations.size(); ++i) {
+                layout.displayedIds[i] = tileAnimations[i].frames[animationFrame[i]];
+            }
+            ++layout.version;
+        }
+
+        void rebuildTileGeometry() {
+            buildLayerGeometry(collisionGeometry, tiles, layout);
+            decorGeometry.resize(decorLayers.size());
+            for (std::size_t i = 0; i < decorLayers.size(); ++i) {
+                buildLayerGeometry(decorGeometry[i], decorLayers[i].tiles, layout);
+            }
+            reportInvalidTiles();
+        }
+
+        void writeAnimatedCells(std::size_t animation) {
+            for (const sf::Vector2i& cell : collisionGeometry.animatedCells[animation]) {
+                writeTileVertices(collisionGeometry, tiles, cell.x, cell.y, layout);
+            }
+            for (std::size_t layer = 0; layer < decorGeometry.size(); ++layer) {
+                for (const sf::Vector2i& cell : decorGeometry[layer].animatedCells[animation]) {
+                    writeTileVertices(decorGeometry[layer], decorLayers[layer].tiles, cell.x, cell.y, layout);
+                }
+            }
+        }
+
+        void reportInvalidTiles() {
+            int invalidId = collisionGeometry.invalidTileId;
+            for (const LayerGeometry& geometry : decorGeometry) {
+                invalidId = invalidId != 0 ? invalidId : geometry.invalidTileId;
+            }
+            if (!warnedInvalidTileIndex && invalidId != 0) {
+                warnedInvalidTileIndex = true;
+                Log::warning(LogCategory::Assets, "level references tile index %d but tileset grid supports up to %d tiles",
+                    invalidId, tilesetColumns * tilesetRows);
+            }
+        }
+
+        static int animationIndexFor(const TileLayout& tileLayout, int id) {
+            const int animation = (id > 0 && id < maxTileIds) ? tileLayout.animationForId[id] : -1;
+            return animation < static_cast<int>(tileLayout.displayedIds.size()) ? animation : -1;
+        }
+
+        static void buildLayerGeometry(LayerGeometry& geometry, const std::vector<std::vector<int>>& grid,
+            const TileLayout& tileLayout) {
+            const int height = static_cast<int>(grid.size());
+            const int width = grid.empty() ? 0 : static_cast<int>(grid[0].size());
+            geometry.columns = (width + chunkTiles - 1) / chunkTiles;
+            geometry.rows = (height + chunkTiles - 1) / chunkTiles;
+            geometry.chunks.assign(static_cast<std::size_t>(geometry.columns * geometry.rows),
+                sf::VertexArray(sf::Triangles));
+            geometry.chunkQuads.assign(geometry.chunks.size(), {});
+            geometry.chunkTileCounts.assign(geometry.chunks.size(), 0);
+            geometry.animatedCells.assign(tileLayout.displayedIds.size(), {});
+            geometry.invalidTileId = 0;
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < static_cast<int>(grid[y].size()) && x < width; ++x) {
+                    const int animation = animationIndexFor(tileLayout, grid[y][x]);
+                    if (animation >= 0) {
+                        geometry.animatedCells[animation].push_back(sf::Vector2i(x, y));
+                    }
+                    writeTileVertices(geometry, grid, x, y, tileLayout);
+                }
+            }
+        }
+
+        static void writeTileVertices(LayerGeometry& geometry, const std::vector<std::vector<int>>& grid, int x, int y,
+            const TileLayout& tileLayout) {
+            const std::size_t chunkIndex = static_cast<std::size_t>((y / chunkTiles) * geometry.columns + x / chunkTiles);
+            if (chunkIndex >= geometry.chunks.size()) {
+                return;
+            }
+            sf::VertexArray& chunk = geometry.chunks[chunkIndex];
+            std::vector<std::uint16_t>& quads = geometry.chunkQuads[chunkIndex];
+            const int id = grid[y][x];
+            const bool empty = id <= 0 || !tileLayout.loaded;
+            if (quads.empty()) {
+                if (empty) {
+                    return;
+                }
+                quads.assign(chunkTiles * chunkTiles, LayerGeometry::noQuad);
+            }
+            std::uint16_t& quad = quads[static_cast<std::size_t>((y % chunkTiles) * chunkTiles + x % chunkTiles)];
+            if (quad == LayerGeometry::noQuad) {
+                if (empty) {
+                    return;
+                }
+                // Cells get a quad when first drawn and keep it if cleared later.
+                quad = static_cast<std::uint16_t>(chunk.getVertexCount() / 6);
+                chunk.resize(chunk.getVertexCount() + 6);
+            }
+            const std::size_t first = static_cast<std::size_t>(quad) * 6;
+            // Cleared cells are degenerate quads, so a drawn cell has distinct corners.
+            const bool wasDrawn = chunk[first].position != chunk[first + 1].position;
+            if (empty) {
+                for (std::size_t i = 0; i < 6; ++i) {
+                    chunk[first + i] = sf::Vertex();
+                }
+                geometry.chunkTileCounts[chunkIndex] -= wasDrawn ? 1 : 0;
+                return;
+            }
+            geometry.chunkTileCounts[chunkIndex] += wasDrawn ? 0 : 1;
+
+            const int maxIndex = tileLayout.columns * tileLayout.rows - 1;
+            const int animation = animationIndexFor(tileLayout, id);
+            const int rawIndex = (animation >= 0 ? tileLayout.displayedIds[animation] : id) - 1;
+            if (geometry.invalidTileId == 0 && rawIndex > maxIndex) {
+                geometry.invalidTileId = id;
+            }
+            const int safeIndex = std::clamp(rawIndex, 0, maxIndex);
+            const float u0 = static_cast<float>(tileLayout.origin.x + (safeIndex % tileLayout.columns) * tileLayout.sourceWidth);
+            const float v0 = static_cast<float>(tileLayout.origin.y + (safeIndex / tileLayout.columns) * tileLayout.sourceHeight);
+            const float u1 = u0 + static_cast<float>(tileLayout.sourceWidth);
+            const float v1 = v0 + static_cast<float>(tileLayout.sourceHeight);
+            const float left = static_cast<float>(x * tileLayout.tileSize);
+            const float top = static_cast<float>(y * tileLayout.tileSize);
+            const float right = left + static_cast<float>(tileLayout.tileSize);
+            const float bottom = top + static_cast<float>(tileLayout.tileSize);
+            chunk[first + 0] = sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u0, v0));
+            chunk[first + 1] = sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(u1, v0));
+            chunk[first + 2] = sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(u0, v1));
+            chunk[first + 3] = sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(u0, v1));
+            chunk[first + 4] = sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(u1, v0));
+            chunk[first + 5] = sf::Vertex(sf::Vector2f(right, bottom), sf::Vector2f(u1, v1));
+        }
+
+        static std::vector<std::string>* parseLayerHeader(const std::string& header, const std::string& path,
+            LevelData& level, std::vector<std::vector<std::string>>& layerLines, std::vector<std::string>& collisionLines) {
+            std::istringstream tokens(header.substr(1, header.find(']') == std::string::npos
+                ? std::string::npos : header.find(']') - 1));
+            std::string name;
+            tokens >> name;
+            if (name == "collision") {
+                return &collisionLines;
+            }
+            TileLayer layer;
+            if (name == "foreground") {
+                layer.foreground = true;
+            }
+            else if (name != "background") {
+                Log::warning(LogCategory::Assets, "%s: unknown layer '%s', treating it as background",
+                    path.c_str(), name.c_str());
+            }
+            float parallaxX = 1.f;
+            if (tokens >> parallaxX) {
+                layer.parallax = sf::Vector2f(parallaxX, parallaxX);
+                float parallaxY = 1.f;
+                if (tokens >> parallaxY) {
+                    layer.parallax.y = parallaxY;
+                }
+            }
+            level.decorLayers.push_back(layer);
+            layerLines.emplace_back();
+            return &layerLines.back();
+        }
+
+        void renderDecorLayers(sf::RenderTarget& target, bool foreground) {
+            if (!tilesetLoaded || !tileTexture) {
+                return;
+            }
+            const sf::View view = target.getView();
+            for (std::size_t i = 0; i < decorLayers.size() && i < decorGeometry.size(); ++i) {
+                const TileLayer& layer = decorLayers[i];
+                if (layer.foreground != foreground) {
+                    continue;
+                }
+                // Shifting the view rather than the vertices keeps every
+                // layer's cached chunks valid however the camera moves.
+                sf::View layerView = view;
+                layerView.setCenter(view.getCenter().x * layer.parallax.x, view.getCenter().y * layer.parallax.y);
+                target.setView(layerView);
+                drawVisibleChunks(target, decorGeometry[i]);
+            }
+            target.setView(view);
+        }
+
+        sf::VertexArray platformVertices{ sf::Triangles };
+        // Kept across frames: a shape allocates its vertex arrays on construction.
+        sf::CircleShape coinShape;
+        sf::RectangleShape powerupShape;
+        sf::RectangleShape goalShape;
+
+        // Platforms move every tick, so their quads are refilled per frame;
+        // the array keeps its capacity and everything goes out in one draw.
+        void drawPlatforms(sf::RenderTarget& target) {
+            if (platforms.empty() || tileSize <= 0) {
+                return;
+            }
+            const sf::View& view = target.getView();
+            const sf::Vector2f halfSize(std::abs(view.getSize().x) / 2.f, std::abs(view.getSize().y) / 2.f);
+            const sf::FloatRect visible(view.getCenter() - halfSize, halfSize * 2.f);
+
+            const int maxIndex = tilesetColumns * tilesetRows - 1;
+            const int safeIndex = std::clamp(displayedTileId(platformTileId) - 1, 0, maxIndex);
+            const float u0 = static_cast<float>(tilesetOrigin.x + (safeIndex % tilesetColumns) * tileSourceWidth);
+            const float v0 = static_cast<float>(tilesetOrigin.y + (safeIndex / tilesetColumns) * tileSourceHeight);
+            const float size = static_cast<float>(tileSize);
+
+            platformVertices.clear();
+            platforms.forEachNear(visible, [&](int, const MovingPlatforms::Platform& platform) {
+                const float u1 = u0 + static_cast<float>(tileSourceWidth);
+                const float v1 = v0 + static_cast<float>(tileSourceHeight) * std::min(1.f, platform.size.y / size);
+                const float top = platform.position.y;
+                const float bottom = top + platform.size.y;
+                for (float left = platform.position.x; left < platform.position.x + platform.size.x; left += size) {
+                    const float right = std::min(left + size, platform.position.x + platform.size.x);
+                    const float u = u0 + (u1 - u0) * (right - left) / size;
+                    platformVertices.append(sf::Vertex(sf::Vector2f(left, top), sf::Vector2f(u0, v0)));
+                    platformVertices.append(sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(u, v0)));
+                    platformVertices.append(sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(u0, v1)));
+                    platformVertices.append(sf::Vertex(sf::Vector2f(left, bottom), sf::Vector2f(u0, v1)));
+                    platformVertices.append(sf::Vertex(sf::Vector2f(right, top), sf::Vector2f(u, v0)));
+                    platformVertices.append(sf::Vertex(sf::Vector2f(right, bottom), sf::Vector2f(u, v1)));
+                }
+            });
+            sf::RenderStates states;
+            states.texture = tileTexture;
+            target.draw(platformVertices, states);
+            Metrics::count(MetricCounter::DrawCalls);
+        }
+
+        void drawVisibleChunks(sf::RenderTarget& target, const LayerGeometry& geometry) const {
+            if (geometry.chunks.empty() || tileSize <= 0) {
+                return;
+            }
+            const sf::View& view = target.getView();
+            const sf::Vector2f center = view.getCenter();
+            const sf::Vector2f halfSize(std::abs(view.getSize().x) / 2.f, std::abs(view.getSize().y) / 2.f);
+            const float chunkPixels = static_cast<float>(chunkTiles * tileSize);
+            const int firstX = std::max(0, static_cast<int>(std::floor((center.x - halfSize.x) / chunkPixels)));
+            const int lastX = std::min(geometry.columns - 1, static_cast<int>(std::floor((center.x + halfSize.x) / chunkPixels)));
+            const int firstY = std::max(0, static_cast<int>(std::floor((center.y - halfSize.y) / chunkPixels)));
+            const int lastY = std::min(geometry.rows - 1, static_cast<int>(std::floor((center.y + halfSize.y) / chunkPixels)));
+            sf::RenderStates states;
+            states.texture = tileTexture;
+            for (int cy = firstY; cy <= lastY; ++cy) {
+                for (int cx = firstX; cx <= lastX; ++cx) {
+                    const std::size_t chunkIndex = static_cast<std::size_t>(cy * geometry.columns + cx);
+                    if (geometry.chunkTileCounts[chunkIndex] == 0) {
+                        continue;
+                    }
+                    target.draw(geometry.chunks[chunkIndex], states);
+                    Metrics::count(MetricCounter::DrawCalls);
+                    Metrics::count(MetricCounter::TilesDrawn, static_cast<std::uint64_t>(geometry.chunkTileCounts[chunkIndex]));
+                }
+            }
+        }
+
         static int tileIndexFromChar(char c) {
             if (std::isdigit(static_cast<unsigned char>(c))) {
                 return c - '0';
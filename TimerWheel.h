@@ -0,0 +1,223 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+// Hierarchical timer wheel for gameplay timers and delayed events. Time is
+// quantised into fixed ticks; each level has 64 slots and covers 64 times the
+// span of the level below. Timers sit in the coarsest level that fits their
+// remaining delay and cascade down as the wheel turns, so a tick only touches
+// timers that are expiring or cascading instead of every pending timer.
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+
+    // Generation-checked reference to a scheduled timer. A default handle, or
+    // one whose timer has fired or been cancelled, is simply not pending.
+    struct Handle {
+        std::uint32_t index = invalidIndex;
+        std::uint32_t generation = 0;
+    };
+
+    explicit TimerWheel(float tickDuration = 1.f / 120.f)
+        : tickDuration(tickDuration) {
+        clear();
+    }
+
+    // Runs callback once, after at least delay seconds of advance() time.
+    Handle schedule(float delay, Callback callback = {}) {
+        const float ticks = std::ceil(std::max(0.f, delay + accumulator) / tickDuration);
+        return scheduleTicks(static_cast<std::uint64_t>(ticks), std::move(callback));
+    }
+
+    Handle scheduleTicks(std::uint64_t ticks, Callback callback = {}) {
+        std::uint32_t index;
+        if (!freeNodes.empty()) {
+            index = freeNodes.back();
+            freeNodes.pop_back();
+        }
+        else {
+            index = static_cast<std::uint32_t>(nodes.size());
+            nodes.emplace_back();
+        }
+        Node& node = nodes[index];
+        node.deadline = currentTick + std::max<std::uint64_t>(ticks, 1);
+        node.callback = std::move(callback);
+        insert(index);
+        ++pendingCount;
+        return Handle{ index, node.generation };
+    }
+
+    // Cancels the timer and resets the handle. Returns false if it was not pending.
+    bool cancel(Handle& handle) {
+        const bool wasPending = pending(handle);
+        if (wasPending) {
+            unlink(handle.index);
+            release(handle.index);
+        }
+        handle = Handle{};
+        return wasPending;
+    }
+
+    bool pending(Handle handle) const {
+        return handle.index < nodes.size()
+            && nodes[handle.index].generation == handle.generation
+            && nodes[handle.index].slot != noSlot;
+    }
+
+    // Seconds left before the timer fires, or 0 if it is not pending.
+    float remaining(Handle handle) const {
+        if (!pending(handle)) {
+            return 0.f;
+        }
+        const float ticks = static_cast<float>(nodes[handle.index].deadline - currentTick);
+        return std::max(0.f, ticks * tickDuration - accumulator);
+    }
+
+    void advance(float dt) {
+        accumulator += std::max(0.f, dt);
+        while (accumulator >= tickDuration) {
+            accumulator -= tickDuration;
+            step();
+        }
+    }
+
+    // Drops every pending timer without running it.
+    void clear() {
+        // Nodes are kept and re-versioned so outstanding handles go stale.
+        freeNodes.clear();
+        for (std::uint32_t index = 0; index < nodes.size(); ++index) {
+            Node& node = nodes[index];
+            node.slot = noSlot;
+            node.prev = invalidIndex;
+            node.next = invalidIndex;
+            node.callback = nullptr;
+            ++node.generation;
+            freeNodes.push_back(index);
+        }
+        std::fill(std::begin(slotHeads), std::end(slotHeads), invalidIndex);
+        pendingCount = 0;
+        accumulator = 0.f;
+    }
+
+    std::size_t size() const {
+        return pendingCount;
+    }
+
+    std::uint64_t getTick() const {
+        return currentTick;
+    }
+
+    float getTickDuration() const {
+        return tickDuration;
+    }
+
+private:
+    static constexpr std::uint32_t invalidIndex = 0xFFFFFFFFu;
+    static constexpr std::uint32_t noSlot = 0xFFFFFFFFu;
+    static constexpr int slotBits = 6;
+    static constexpr std::uint64_t slotsPerLevel = 1u << slotBits;
+    static constexpr std::uint64_t slotMask = slotsPerLevel - 1;
+    static constexpr int levelCount = 4;
+
+    struct Node {
+        std::uint64_t deadline = 0;
+        std::uint32_t generation = 0;
+        std::uint32_t slot = noSlot;
+        std::uint32_t prev = invalidIndex;
+        std::uint32_t next = invalidIndex;
+        Callback callback;
+    };
+
+    float tickDuration;
+    float accumulator = 0.f;
+    std::uint64_t currentTick = 0;
+    std::size_t pendingCount = 0;
+    std::vector<Node> nodes;
+    std::vector<std::uint32_t> freeNodes;
+    std::uint32_t slotHeads[levelCount * slotsPerLevel];
+
+    void insert(std::uint32_t index) {
+        Node& node = nodes[index];
+        const std::uint64_t delta = node.deadline - currentTick;
+        int level = 0;
+        while (level < levelCount - 1 && delta >= (slotsPerLevel << (slotBits * level))) {
+            ++level;
+        }
+        std::uint64_t slotTick = node.deadline;
+        if (delta >= (slotsPerLevel << (slotBits * level))) {
+            // Beyond the wheel's horizon: park in the furthest top-level slot
+            // and re-place it when that slot cascades.
+            slotTick = currentTick + (slotMask << (slotBits * level));
+        }
+        const std::uint32_t slot = static_cast<std::uint32_t>(
+            level * slotsPerLevel + ((slotTick >> (slotBits * level)) & slotMask));
+        node.slot = slot;
+        node.prev = invalidIndex;
+        node.next = slotHeads[slot];
+        if (node.next != invalidIndex) {
+            nodes[node.next].prev = index;
+        }
+        slotHeads[slot] = index;
+    }
+
+    void unlink(std::uint32_t index) {
+        Node& node = nodes[index];
+        if (node.prev != invalidIndex) {
+            nodes[node.prev].next = node.next;
+        }
+        else {
+            slotHeads[node.slot] = node.next;
+        }
+        if (node.next != invalidIndex) {
+            nodes[node.next].prev = node.prev;
+        }
+        node.slot = noSlot;
+        node.prev = invalidIndex;
+        node.next = invalidIndex;
+    }
+
+    void release(std::uint32_t index) {
+        Node& node = nodes[index];
+        node.callback = nullptr;
+        ++node.generation;
+        freeNodes.push_back(index);
+        --pendingCount;
+    }
+
+    // Re-places every timer in a coarse slot; each lands in a finer level.
+    void cascade(int level) {
+        const std::uint32_t slot = static_cast<std::uint32_t>(
+            level * slotsPerLevel + ((currentTick >> (slotBits * level)) & slotMask));
+        std::uint32_t index = slotHeads[slot];
+        slotHeads[slot] = invalidIndex;
+        while (index != invalidIndex) {
+            const std::uint32_t next = nodes[index].next;
+            insert(index);
+            index = next;
+        }
+    }
+
+    void step() {
+        ++currentTick;
+        for (int level = 1; level < levelCount; ++level) {
+            if ((currentTick & ((std::uint64_t(1) << (slotBits * level)) - 1)) != 0) {
+                break;
+            }
+            cascade(level);
+        }
+        // Callbacks may schedule or cancel timers, so pop one at a time.
+        const std::uint32_t slot = static_cast<std::uint32_t>(currentTick & slotMask);
+        while (slotHeads[slot] != invalidIndex) {
+            const std::uint32_t index = slotHeads[slot];
+            unlink(index);
+            Callback callback = std::move(nodes[index].callback);
+            release(index);
+            if (callback) {
+                callback();
+            }
+        }
+    }
+};
@@ -2,7 +2,10 @@
 
 
 Window::Window(const std::string& title, int width, int  height) : window(sf::VideoMode(width, height), title) {
-	window.setFramerateLimit(60);
+}
+
+void Window::create(const std::string& title, int width, int height) {
+	window.create(sf::VideoMode(width, height), title);
 }
 
 void Window::beginDraw() {
@@ -15,6 +18,16 @@ void Window::endDraw() {
 
 }
 
+// Same as sf::Window::setFramerateLimit, but run after display() rather than
+// inside it, so callers can time the presented frame without the sleep.
+void Window::waitForFrameLimit() {
+	const sf::Time remaining = frameTimeLimit - frameClock.getElapsedTime();
+	if (remaining > sf::Time::Zero) {
+		sf::sleep(remaining);
+	}
+	frameClock.restart();
+}
+
 void Window::processEvents() {
 	sf::Event event;
 	while (window.pollEvent(event)) {
@@ -26,6 +39,10 @@ void Window::processEvents() {
 bool Window::pollEvent(sf::Event& event) {
 	return window.pollEvent(event);
 
+}
+bool Window::waitEvent(sf::Event& event) {
+	return window.waitEvent(event);
+
 }
 void Window::close() {
 	window.close();
@@ -3,17 +3,23 @@
 
 class Window {
 public: 
+	Window() = default; // not opened until create(); headless runs never open one
 	Window(const std::string& title, int width, int height);
+	void create(const std::string& title, int width, int height);
 	void beginDraw();
 	void endDraw();
+	void waitForFrameLimit();
 	void processEvents();
 	bool pollEvent(sf::Event& event);
+	bool waitEvent(sf::Event& event);
 	void close();
 	bool isOpen();
 	sf::RenderWindow& getRenderWindow();
 
 private:
 	sf::RenderWindow window;
+	sf::Time frameTimeLimit = sf::seconds(1.f / 60.f);
+	sf::Clock frameClock;
 
 
 };